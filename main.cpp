@@ -2,6 +2,5 @@
 
 int main(int argc, char** argv)
 {
-    LerpWithQuats::main(argc, argv);
-	return 0;
+    return LerpWithQuats::main(argc, argv);
 }
\ No newline at end of file
@@ -0,0 +1,439 @@
+#include "MotionSample.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Samples keyframed tracks into poses without a window.
+//
+//   poseSampler <input> <output|-> [--rate r] [--threads n] [--batch samples] [--fast]
+//
+// Input is CSV or binary, told apart by the magic. Either way it is a list of
+// keyframes; consecutive keyframes with the same track id form a track, and
+// each pair of neighbours is one motion, with the speed and mode of the first.
+// A keyframe pair is simply a track of two.
+//
+//   CSV    : track,qw,qx,qy,qz,x,y,z,speed,mode per line; '#' starts a comment
+//   binary : "LWQK" | u32 version | keyframe records until end of file
+//            record: u32 track | u32 mode | f32 q[4] (w,x,y,z) | f32 t[3] | f32 speed
+//
+// Output (native endianness):
+//
+//   header : "LWQS" | u32 version | u32 recordBytes
+//   record : u32 track | f32 time | f32 q[4] (w,x,y,z) | f32 t[3]
+//
+// Each motion is sampled every 1 / rate ticks from its start, time counting
+// in ticks from the start of the track; the last motion of a track also gets
+// a sample at its end. Without --fast, every pose is sampleMotion(), the
+// function MotionTrack samples motion scripts with, so at integer ticks
+// (rate 1) it matches the running application bit for bit. --fast blends rotations
+// with a normalized lerp instead of slerp for Separate motions.
+//
+// Input is processed in batches of at most --batch samples (default 1M, 36 MB
+// of output), each spread over all cores and then written out, so memory
+// stays bounded however long the input is. Throughput goes to stderr as JSON.
+
+constexpr char keyframeMagic[4]{'L', 'W', 'Q', 'K'};
+constexpr char sampleMagic[4]{'L', 'W', 'Q', 'S'};
+constexpr std::uint32_t samplerVersion{1};
+
+struct KeyframeRecord
+{
+    std::uint32_t track;
+    std::uint32_t mode;
+    float rotation[4];
+    float translation[3];
+    float speed;
+};
+
+struct SampleRecord
+{
+    std::uint32_t track;
+    float time;
+    float rotation[4];
+    float translation[3];
+};
+
+static_assert(sizeof(KeyframeRecord) == 40);
+static_assert(sizeof(SampleRecord) == 36);
+
+struct KeyframeReader
+{
+    explicit KeyframeReader(const std::string& path)
+    :
+        in{path, std::ios::binary},
+        binary{},
+        malformed{},
+        line{}
+    {
+        if(!in)
+        {
+            std::cerr << "Can't open " << path << std::endl;
+            return;
+        }
+
+        char magic[4]{};
+        in.read(magic, sizeof(magic));
+
+        if(in.gcount() == sizeof(magic) && std::memcmp(magic, keyframeMagic, sizeof(magic)) == 0)
+        {
+            std::uint32_t version{};
+            in.read(reinterpret_cast<char*>(&version), sizeof(version));
+
+            if(version != samplerVersion)
+            {
+                std::cerr << path << ": unsupported keyframe version " << version << std::endl;
+                in.setstate(std::ios::failbit);
+            }
+
+            binary = true;
+            return;
+        }
+
+        in.clear();
+        in.seekg(0);
+    }
+
+    bool isOpen() const
+    {
+        return bool(in);
+    }
+
+    // Modes are MotionMode values; a speed of zero or NaN has no duration.
+    static bool isValid(const KeyframeRecord& r)
+    {
+        return r.mode <= 2 && r.speed > 0.f;
+    }
+
+    // False at the end of the input or on a malformed line or record, which is
+    // reported and sets `malformed`.
+    bool next(KeyframeRecord& r)
+    {
+        if(binary)
+        {
+            if(!in.read(reinterpret_cast<char*>(&r), sizeof(r)))
+            {
+                if(in.gcount() != 0)
+                {
+                    std::cerr << "record " << line + 1 << ": truncated at the end of the input" << std::endl;
+                    malformed = true;
+                }
+
+                return false;
+            }
+
+            ++line;
+
+            if(!isValid(r))
+            {
+                std::cerr << "record " << line << ": expected mode 0 to 2 and a positive speed" << std::endl;
+                malformed = true;
+                return false;
+            }
+
+            return true;
+        }
+
+        std::string text;
+
+        while(std::getline(in, text))
+        {
+            ++line;
+
+            const auto comment = text.find('#');
+            if(comment != std::string::npos)
+                text.erase(comment);
+
+            if(text.find_first_not_of(" \t\r") == std::string::npos)
+                continue;
+
+            std::replace(text.begin(), text.end(), ',', ' ');
+            std::istringstream fields{text};
+
+            fields >> r.track >> r.rotation[0] >> r.rotation[1] >> r.rotation[2] >> r.rotation[3]
+                   >> r.translation[0] >> r.translation[1] >> r.translation[2] >> r.speed >> r.mode;
+
+            if(!fields || !isValid(r))
+            {
+                std::cerr << "line " << line << ": expected track,qw,qx,qy,qz,x,y,z,speed,mode" << std::endl;
+                malformed = true;
+                return false;
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    std::ifstream in;
+    bool binary;
+    bool malformed;
+    std::uint64_t line;	// or record, in binary input
+};
+
+// One motion of a track, or the part of it that fits into the current batch.
+struct Segment
+{
+    std::uint32_t track;
+    MotionSpec spec;
+    float duration;
+    double trackTime;		// ticks from the track's start to this motion's
+    std::uint64_t steps;	// samples strictly before the end
+    std::uint64_t first;	// first sample of this part
+    std::uint64_t count;	// samples in this part; step index `steps` is the end
+    std::uint64_t offset;	// into the batch
+};
+
+static SampleRecord makeRecord(std::uint32_t track, double time, const Pose& pose)
+{
+    return {
+        track, float(time),
+        {pose.rotation.w, pose.rotation.x, pose.rotation.y, pose.rotation.z},
+        {pose.translation.X, pose.translation.Y, pose.translation.Z}
+    };
+}
+
+static Pose sampleMotionFast(const MotionSpec& spec, float ticks)
+{
+    if(spec.mode != MotionMode::Separate)
+        return sampleMotion(spec, ticks);
+
+    const float t = getMotionProgress(spec, ticks);
+    const float s = QuaternionDotProduct(spec.rotStart, spec.rotEnd) < 0.f ? -t : t;
+    const auto& a = spec.rotStart;
+    const auto& b = spec.rotEnd;
+    const float u = 1.f - t;
+
+    Pose r;
+    r.rotation = normalizeQuat({a.w * u + b.w * s, a.x * u + b.x * s, a.y * u + b.y * s, a.z * u + b.z * s});
+    r.translation = lerp(spec.start, spec.end, t);
+
+    return r;
+}
+
+static int printUsage()
+{
+    std::cerr << "usage: poseSampler <input> <output|-> [--rate r] [--threads n] [--batch samples] [--fast]"
+              << std::endl;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    using namespace std::chrono;
+
+    std::string inputPath;
+    std::string outputPath;
+    double rate{1.0};
+    unsigned threads{};
+    std::uint64_t batchSamples{1u << 20};
+    bool fast{};
+
+    for(int i = 1; i < argc; ++i)
+    {
+        const std::string arg{argv[i]};
+
+        if(arg == "--rate" && i + 1 < argc)
+            rate = std::stod(argv[++i]);
+        else if(arg == "--threads" && i + 1 < argc)
+            threads = unsigned(std::stoul(argv[++i]));
+        else if(arg == "--batch" && i + 1 < argc)
+            batchSamples = std::max<std::uint64_t>(std::stoull(argv[++i]), 1);
+        else if(arg == "--fast")
+            fast = true;
+        else if(arg.size() > 1 && arg[0] == '-')
+            return printUsage();
+        else if(inputPath.empty())
+            inputPath = arg;
+        else
+            outputPath = arg;
+    }
+
+    if(inputPath.empty() || outputPath.empty() || !(rate > 0.0))
+        return printUsage();
+
+    KeyframeReader reader{inputPath};
+    if(!reader.isOpen())
+        return 1;
+
+    std::FILE* out = outputPath == "-" ? stdout : std::fopen(outputPath.c_str(), "wb");
+    if(out == nullptr)
+    {
+        std::cerr << "Can't open " << outputPath << std::endl;
+        return 1;
+    }
+
+    const std::uint32_t recordBytes{sizeof(SampleRecord)};
+    std::fwrite(sampleMagic, 1, sizeof(sampleMagic), out);
+    std::fwrite(&samplerVersion, sizeof(samplerVersion), 1, out);
+    std::fwrite(&recordBytes, sizeof(recordBytes), 1, out);
+
+    ThreadPool pool{threads};
+    const auto sample = fast ? sampleMotionFast : sampleMotion;
+
+    std::vector<Segment> batch;
+    std::vector<SampleRecord> records;
+    std::uint64_t batched{};
+
+    std::uint64_t keyframes{};
+    std::uint64_t motions{};
+    std::uint64_t samples{};
+    double sampleSeconds{};
+    bool ok{true};
+
+    const auto start = steady_clock::now();
+
+    const auto flush = [&]
+    {
+        if(batched == 0)
+            return;
+
+        records.resize(batched);
+
+        const auto computeStart = steady_clock::now();
+
+        pool.parallelFor(batch.size(), 16, [&](std::size_t begin, std::size_t end)
+        {
+            for(std::size_t i = begin; i < end; ++i)
+            {
+                const auto& s = batch[i];
+
+                for(std::uint64_t j = 0; j < s.count; ++j)
+                {
+                    const auto k = s.first + j;
+                    const float local = k < s.steps ? float(double(k) / rate) : s.duration;
+
+                    records[s.offset + j] = makeRecord(s.track, s.trackTime + local, sample(s.spec, local));
+                }
+            }
+        });
+
+        sampleSeconds += duration<double>(steady_clock::now() - computeStart).count();
+
+        if(std::fwrite(records.data(), sizeof(SampleRecord), records.size(), out) != records.size())
+        {
+            std::cerr << "Can't write " << outputPath << std::endl;
+            ok = false;
+        }
+
+        samples += batched;
+        batch.clear();
+        batched = 0;
+    };
+
+    // Splits the motion across batches as needed.
+    const auto add = [&](Segment s, bool last)
+    {
+        std::uint64_t remaining = s.steps + (last ? 1 : 0);
+        s.first = 0;
+
+        while(remaining > 0 && ok)
+        {
+            s.count = std::min(remaining, batchSamples - batched);
+            s.offset = batched;
+            batch.push_back(s);
+
+            batched += s.count;
+            s.first += s.count;
+            remaining -= s.count;
+
+            if(batched == batchSamples)
+                flush();
+        }
+
+        ++motions;
+    };
+
+    KeyframeRecord previous{};
+    KeyframeRecord current{};
+    bool havePrevious{};
+    Segment pending{};
+    bool havePending{};
+    double trackTime{};
+
+    while(ok && reader.next(current))
+    {
+        ++keyframes;
+
+        if(havePrevious && previous.track == current.track)
+        {
+            if(havePending)
+                add(pending, false);
+
+            auto& spec = pending.spec;
+            spec.rotStart = {previous.rotation[0], previous.rotation[1], previous.rotation[2], previous.rotation[3]};
+            spec.rotEnd = {current.rotation[0], current.rotation[1], current.rotation[2], current.rotation[3]};
+            spec.start = {previous.translation[0], previous.translation[1], previous.translation[2]};
+            spec.end = {current.translation[0], current.translation[1], current.translation[2]};
+            spec.speed = previous.speed;
+            spec.mode = static_cast<MotionMode>(previous.mode);
+
+            pending.track = current.track;
+            pending.duration = getMotionDuration(spec);
+            pending.trackTime = trackTime;
+
+            // A speed just above zero makes a motion too long to sample, or infinite.
+            const double steps = std::ceil(double(pending.duration) * rate);
+            if(!(steps < 1e15))
+            {
+                std::cerr << "keyframe " << keyframes << ": a motion of " << pending.duration
+                          << " ticks is too long to sample" << std::endl;
+                ok = false;
+                break;
+            }
+
+            pending.steps = std::uint64_t(steps);
+            havePending = true;
+
+            trackTime += pending.duration;
+        }
+        else
+        {
+            if(havePending)
+                add(pending, true);
+
+            havePending = false;
+            trackTime = 0.0;
+        }
+
+        previous = current;
+        havePrevious = true;
+    }
+
+    ok = ok && !reader.malformed;
+
+    if(ok && havePending)
+        add(pending, true);
+
+    flush();
+
+    if(out != stdout)
+        std::fclose(out);
+    else
+        std::fflush(out);
+
+    if(!ok)
+        return 1;
+
+    const double seconds = duration<double>(steady_clock::now() - start).count();
+
+    std::cerr << "{\"keyframes\": " << keyframes
+              << ", \"motions\": " << motions
+              << ", \"samples\": " << samples
+              << ", \"threads\": " << pool.getThreadCount()
+              << ", \"mode\": \"" << (fast ? "fast" : "exact") << "\""
+              << ", \"seconds\": " << seconds
+              << ", \"samplesPerSecond\": " << double(samples) / std::max(seconds, 1e-9)
+              << ", \"samplingSamplesPerSecond\": " << double(samples) / std::max(sampleSeconds, 1e-9)
+              << ", \"bytes\": " << 12 + samples * sizeof(SampleRecord) << "}" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,282 @@
+#include "Shard.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Runs the sharded fleet simulation (see Shard.h) as one process per shard on
+// this machine and checks it against a single-process run.
+//
+//   shardSim [--actors n] [--steps n] [--shards n] [--max-shards n] [--radius r] [--seed n]
+//
+// The reference run is one shard in this process. Then the world is split
+// into 1, 2, ... --max-shards (default 8) shards, or only into --shards; each
+// split forks one process per shard, neighbours connected by Unix domain
+// socket pairs. Every run must end with the reference's checksum, which
+// covers every actor's pose and neighbour count at every step. The report
+// goes to stdout as JSON: step loop time (the slowest shard's), speedup over
+// the one-shard run, and migration and ghost traffic. Exits with 1 on a
+// mismatch or a failed shard.
+
+struct ForkedRun
+{
+    std::vector<ShardStats> shards;
+    double wallSeconds{};
+};
+
+static bool readAll(int fd, void* data, std::size_t size)
+{
+    auto* bytes = static_cast<char*>(data);
+
+    while(size > 0)
+    {
+        const auto n = read(fd, bytes, size);
+        if(n <= 0)
+            return false;
+
+        bytes += n;
+        size -= std::size_t(n);
+    }
+
+    return true;
+}
+
+static bool runForked(const ShardConfig& config, std::uint64_t steps, ForkedRun& run)
+{
+    using namespace std::chrono;
+
+    const unsigned count = config.shardCount;
+
+    // neighbours[k] joins shard k (end 0) and shard k + 1 (end 1).
+    std::vector<std::array<int, 2>> neighbours(count - 1);
+    std::vector<std::array<int, 2>> reports(count);
+
+    for(auto& pair : neighbours)
+    {
+        if(socketpair(AF_UNIX, SOCK_STREAM, 0, pair.data()) != 0)
+        {
+            std::perror("socketpair");
+            return false;
+        }
+    }
+
+    for(auto& pipeFds : reports)
+    {
+        if(pipe(pipeFds.data()) != 0)
+        {
+            std::perror("pipe");
+            return false;
+        }
+    }
+
+    const auto start = steady_clock::now();
+    std::vector<pid_t> children;
+
+    for(unsigned i = 0; i < count; ++i)
+    {
+        const pid_t pid = fork();
+
+        if(pid < 0)
+        {
+            std::perror("fork");
+            break;
+        }
+
+        if(pid > 0)
+        {
+            children.push_back(pid);
+            continue;
+        }
+
+        // Keep only this shard's ends, so a dead neighbour reads as a closed link.
+        const int leftFd = i > 0 ? neighbours[i - 1][1] : -1;
+        const int rightFd = i + 1 < count ? neighbours[i][0] : -1;
+
+        for(const auto& pair : neighbours)
+            for(const int fd : pair)
+                if(fd != leftFd && fd != rightFd)
+                    close(fd);
+
+        for(unsigned k = 0; k < count; ++k)
+        {
+            close(reports[k][0]);
+            if(k != i)
+                close(reports[k][1]);
+        }
+
+        ShardLink left{leftFd};
+        ShardLink right{rightFd};
+        ShardStats stats;
+
+        const bool ok = runShard(config, i, steps, left.isOpen() ? &left : nullptr,
+                                 right.isOpen() ? &right : nullptr, stats);
+
+        if(ok && write(reports[i][1], &stats, sizeof(stats)) != ssize_t(sizeof(stats)))
+            _exit(1);
+
+        _exit(ok ? 0 : 1);
+    }
+
+    for(const auto& pair : neighbours)
+    {
+        close(pair[0]);
+        close(pair[1]);
+    }
+
+    for(const auto& pipeFds : reports)
+        close(pipeFds[1]);
+
+    bool ok = children.size() == count;
+    run.shards.assign(count, ShardStats{});
+
+    for(unsigned i = 0; i < count; ++i)
+    {
+        if(!readAll(reports[i][0], &run.shards[i], sizeof(ShardStats)))
+            ok = false;
+
+        close(reports[i][0]);
+    }
+
+    for(const auto pid : children)
+    {
+        int status{};
+        waitpid(pid, &status, 0);
+
+        if(!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            ok = false;
+    }
+
+    run.wallSeconds = duration<double>(steady_clock::now() - start).count();
+    return ok;
+}
+
+static int printUsage()
+{
+    std::cerr << "usage: shardSim [--actors n] [--steps n] [--shards n] [--max-shards n] [--radius r] [--seed n]"
+              << std::endl;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    ShardConfig config;
+    std::uint64_t steps{200};
+    unsigned minShards{1};
+    unsigned maxShards{8};
+
+    for(int i = 1; i < argc; ++i)
+    {
+        const std::string arg{argv[i]};
+
+        if(i + 1 >= argc)
+            return printUsage();
+
+        if(arg == "--actors")
+            config.actorCount = std::stoull(argv[++i]);
+        else if(arg == "--steps")
+            steps = std::stoull(argv[++i]);
+        else if(arg == "--shards")
+            minShards = maxShards = unsigned(std::stoul(argv[++i]));
+        else if(arg == "--max-shards")
+            maxShards = unsigned(std::stoul(argv[++i]));
+        else if(arg == "--radius")
+            config.radius = std::stof(argv[++i]);
+        else if(arg == "--seed")
+            config.seed = std::stoull(argv[++i]);
+        else
+            return printUsage();
+    }
+
+    if(minShards == 0 || maxShards < minShards || !(config.radius > 0.f))
+        return printUsage();
+
+    ShardStats reference;
+    if(!runShard(config, 0, steps, nullptr, nullptr, reference))
+        return 1;
+
+    std::cout << "{\n"
+              << "  \"actors\": " << config.actorCount << ",\n"
+              << "  \"steps\": " << steps << ",\n"
+              << "  \"radius\": " << config.radius << ",\n"
+              << "  \"cores\": " << std::thread::hardware_concurrency() << ",\n"
+              << "  \"reference\": {\"seconds\": " << reference.seconds
+              << ", \"neighbours\": " << reference.neighbours
+              << ", \"checksum\": \"" << std::hex << reference.checksum << std::dec << "\"},\n"
+              << "  \"runs\": [";
+
+    bool allMatch{true};
+    double oneShardSeconds{};
+    const char* separator = "\n";
+
+    for(unsigned shards = minShards; shards <= maxShards; ++shards)
+    {
+        config.shardCount = shards;
+
+        if(2.f * config.extent / float(shards) < getShardGhostMargin(config))
+        {
+            std::cerr << shards << " shards: slabs narrower than the ghost margin, skipped" << std::endl;
+            continue;
+        }
+
+        ForkedRun run;
+        if(!runForked(config, steps, run))
+        {
+            std::cerr << shards << " shards: a shard failed" << std::endl;
+            allMatch = false;
+            continue;
+        }
+
+        ShardStats total;
+        double slowest{};
+        std::uint64_t fewest{~std::uint64_t{}};
+        std::uint64_t most{};
+
+        for(const auto& s : run.shards)
+        {
+            total.checksum += s.checksum;
+            total.neighbours += s.neighbours;
+            total.emigrants += s.emigrants;
+            total.ghostsSent += s.ghostsSent;
+            total.bytesSent += s.bytesSent;
+            total.actors += s.actors;
+            slowest = std::max(slowest, s.seconds);
+            fewest = std::min(fewest, s.actors);
+            most = std::max(most, s.actors);
+        }
+
+        if(shards == 1)
+            oneShardSeconds = slowest;
+
+        const bool match = total.checksum == reference.checksum && total.neighbours == reference.neighbours
+                           && total.actors == config.actorCount;
+        allMatch = allMatch && match;
+
+        std::cout << separator
+                  << "    {\"shards\": " << shards
+                  << ", \"match\": " << (match ? "true" : "false")
+                  << ", \"seconds\": " << slowest
+                  << ", \"wallSeconds\": " << run.wallSeconds
+                  << ", \"stepsPerSecond\": " << double(steps) / std::max(slowest, 1e-9);
+
+        if(oneShardSeconds > 0.0)
+            std::cout << ", \"speedup\": " << oneShardSeconds / std::max(slowest, 1e-9);
+
+        std::cout << ", \"migrations\": " << total.emigrants
+                  << ", \"ghosts\": " << total.ghostsSent
+                  << ", \"bytes\": " << total.bytesSent
+                  << ", \"actorsPerShard\": [" << fewest << ", " << most << "]}";
+
+        separator = ",\n";
+    }
+
+    std::cout << "\n  ],\n  \"allMatch\": " << (allMatch ? "true" : "false") << "\n}" << std::endl;
+
+    return allMatch ? 0 : 1;
+}
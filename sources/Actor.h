@@ -2,14 +2,22 @@
 
 #include <iostream>
 #include <vector>
+#include <memory_resource>
+#include <string>
 #include <functional>
+#include <cstdint>
 #include "Utils.h"
+#include "Pose.h"
+#include "RenderSnapshot.h"
 
 struct Actor
 {
-	Actor()
+	explicit Actor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
 		:
-		died{}
+		tags{resource},
+		died{},
+		tickGroup{noTickGroup},
+		tickSlot{}
 	{
 
 	}
@@ -17,8 +25,33 @@ struct Actor
 	virtual void init() {}
 	virtual ~Actor() = default;
 	virtual void tick(float deltaTime) = 0;
-	virtual void setTransform(const Transform& newTransform) = 0;
-	virtual Transform getTransform() const = 0;
+
+	// Called instead of tick() by tick groups slower than every frame; steps
+	// is the number of frames since the previous call.
+	virtual void tickSteps(float deltaTime, unsigned steps)
+	{
+		for (unsigned i = 0; i < steps; ++i)
+			tick(deltaTime / float(steps));
+	}
+
+	// Nothing to do until an event arrives. Checked after each tick; a dormant
+	// actor is not ticked again until TickScheduler::wake.
+	virtual bool isDormant() const
+	{
+		return false;
+	}
+
+	virtual void draw(RenderSnapshot& snapshot) const = 0;
+
+	// Draws the actor as it should look `frames` frames after its last tick,
+	// for groups ticking slower than every frame. By default, as ticked.
+	virtual void drawAhead(RenderSnapshot& snapshot, unsigned) const
+	{
+		draw(snapshot);
+	}
+
+	virtual void setPose(const Pose& newPose) = 0;
+	virtual Pose getPose() const = 0;
 	virtual void die();
 
 	void resetTick()
@@ -32,10 +65,17 @@ struct Actor
 		return tickCalled;
 	}
 
-	std::vector<std::string> tags;
+	std::pmr::vector<std::pmr::string> tags;
+
+	static constexpr std::uint32_t noTickGroup{~0u};
 	
 private:
+	friend struct TickScheduler;
+
 	bool died;
 	bool tickCalled;
+
+	std::uint32_t tickGroup;
+	std::uint32_t tickSlot;
 };
 	
\ No newline at end of file
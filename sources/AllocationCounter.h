@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstdint>
+
+// Number of global operator new calls since program start, from any thread.
+std::uint64_t getAllocationCount() noexcept;
+
+// Peak resident set size of the process in kilobytes, 0 where unsupported.
+std::uint64_t getPeakRssKb() noexcept;
@@ -0,0 +1,1167 @@
+#include "LerpWithQuats.h"
+#include "PoseBlender.h"
+#include "AllocationCounter.h"
+#include "FrameTimeStats.h"
+#include "DualQuaternion.h"
+#include "MotionSample.h"
+#include "ThreadPool.h"
+#include "DeadReckoning.h"
+#include "SimdMath.h"
+#include <atomic>
+#include <iostream>
+
+// Measurement modes of the application (--bench and --bench-*). Each prints
+// its report to stdout as JSON and returns the process exit code.
+
+// The application's own simulation step over the whole scene, without
+// rendering: frame times, allocations and per tick group cost.
+static int runFrameBenchmark(std::uint64_t frameCount, void (*tick)(), const Scene& scene,
+                             const TickScheduler& scheduler, const MotionCache* motionCache)
+{
+    using namespace std::chrono;
+
+    std::vector<double> frameTimes;
+    frameTimes.reserve(frameCount);
+
+    const auto allocationsBefore = getAllocationCount();
+    const auto start = steady_clock::now();
+
+    for(std::uint64_t frame = 0; frame < frameCount; ++frame)
+    {
+        const auto frameStart = steady_clock::now();
+        tick();
+        frameTimes.push_back(duration<double, std::milli>(steady_clock::now() - frameStart).count());
+    }
+
+    const double seconds = duration<double>(steady_clock::now() - start).count();
+    const auto allocations = getAllocationCount() - allocationsBefore;
+
+    const auto stats = FrameTimeStats::compute(frameTimes);
+    const double frames = double(std::max<std::uint64_t>(frameCount, 1));
+
+    std::cout << "{\n"
+        << "  \"actors\": " << scene.size() << ",\n"
+        << "  \"frames\": " << frameCount << ",\n"
+        << "  \"seconds\": " << seconds << ",\n"
+        << "  \"framesPerSecond\": " << frameCount / seconds << ",\n"
+        << "  \"actorUpdatesPerSecond\": " << frameCount * scene.size() / seconds << ",\n"
+        << "  \"frameTimeMs\": {"
+        << "\"mean\": " << stats.mean
+        << ", \"p50\": " << stats.p50
+        << ", \"p95\": " << stats.p95
+        << ", \"p99\": " << stats.p99
+        << ", \"max\": " << stats.max << "},\n"
+        << "  \"peakRssKb\": " << getPeakRssKb() << ",\n"
+        << "  \"allocationsPerFrame\": " << allocations / frames << ",\n";
+
+    if(motionCache)
+    {
+        const auto& cache = motionCache->getStats();
+
+        std::cout << "  \"motionCache\": {\"lookups\": " << cache.lookups
+            << ", \"hitRate\": " << cache.getHitRate()
+            << ", \"entries\": " << cache.entries
+            << ", \"bytes\": " << cache.bytes
+            << ", \"evictions\": " << cache.evictions << "},\n";
+    }
+
+    std::cout << "  \"tickGroups\": [\n";
+
+    const auto& groups = scheduler.getStats();
+    for(std::size_t i = 0; i < groups.size(); ++i)
+    {
+        const auto& g = groups[i];
+
+        std::cout << "    {\"name\": \"" << g.name << "\""
+            << ", \"interval\": " << g.interval
+            << ", \"actors\": " << g.actors
+            << ", \"sleeping\": " << g.sleeping
+            << ", \"ticksPerFrame\": " << g.totalTicked / frames
+            << ", \"msPerFrame\": " << g.totalMilliseconds / frames << "}"
+            << (i + 1 < groups.size() ? ",\n" : "\n");
+    }
+
+    std::cout << "  ]\n}" << std::endl;
+
+    return 0;
+}
+
+// The blending stage of a fleet, per actor a base pose, a look-at layer
+// pulled in by a weight and an additive wobble, through PoseBlender and as
+// the slerps it stands in for. Alongside, two blend layers against slerp and
+// a stack of blend layers against chained slerps, with the largest
+// differences.
+static int runBlendBenchmark(std::size_t n)
+{
+    using namespace std::chrono;
+
+    constexpr std::size_t stackLayers = 4;
+    constexpr int repeats = 20;
+
+    // Layers of one actor point roughly the same way; within 60 degrees of
+    // the base here.
+    const auto near = [](const Quaternion& base, float maxDegrees)
+    {
+        const auto axis = normalize(getRandomLocation(1.f));
+        return normalizeQuat(base * makeQuatFromAxisAngle(axis, Random::get().getRandomFloat(0.f, maxDegrees)));
+    };
+
+    std::vector<Quaternion> rotations(n * stackLayers);
+    std::vector<Vector> translations(n * stackLayers);
+    std::vector<float> weights(n * stackLayers);
+    std::vector<Quaternion> wobbles(n);
+    std::vector<Vector> wobbleOffsets(n);
+
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        const auto base = getRandomOrientation();
+        const auto location = getRandomLocation(100.f);
+
+        for(std::size_t k = 0; k < stackLayers; ++k)
+        {
+            rotations[i * stackLayers + k] = k == 0 ? base : near(base, 60.f);
+            translations[i * stackLayers + k] = location + getRandomLocation(2.f);
+            weights[i * stackLayers + k] = Random::get().getRandomFloat(0.1f, 1.f);
+        }
+
+        wobbles[i] = near(Quaternion{1.f}, 15.f);
+        wobbleOffsets[i] = getRandomLocation(0.5f);
+    }
+
+    std::vector<Quaternion> expectedRotations(n);
+    std::vector<Vector> expectedTranslations(n);
+
+    const auto time = [&](auto&& body)
+    {
+        const auto start = steady_clock::now();
+
+        for(int r = 0; r < repeats; ++r)
+        {
+            body();
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        }
+
+        return duration<double, std::nano>(steady_clock::now() - start).count() / double(std::max<std::size_t>(n, 1) * repeats);
+    };
+
+    struct Result
+    {
+        double blenderNs;
+        double slerpNs;
+        double maxAngle;
+        double maxTranslation;
+    };
+
+    double checksum{};
+
+    const auto compare = [&](const PoseBlender& blender, double blenderNs, double slerpNs)
+    {
+        Result r{blenderNs, slerpNs, 0.0, 0.0};
+
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            const auto q = blender.getOrientation(i);
+            const auto t = blender.getTranslation(i);
+            const float dot = std::abs(QuaternionDotProduct(q, expectedRotations[i]));
+
+            r.maxAngle = std::max(r.maxAngle, 2.0 * toDegrees(std::acos(clamp(0.f, 1.f, dot))));
+            r.maxTranslation = std::max(r.maxTranslation, double((t - expectedTranslations[i]).length()));
+            checksum += q.w + t.X;
+        }
+
+        return r;
+    };
+
+    // Two blend layers weighted 1 - t and t, against slerp and lerp by t.
+    PoseBlender pair{n};
+    pair.addLayer(PoseBlender::LayerMode::Blend);
+    pair.addLayer(PoseBlender::LayerMode::Blend);
+
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        const float t = weights[i * stackLayers];
+        pair.setSource(0, i, rotations[i * stackLayers], translations[i * stackLayers], 1.f - t);
+        pair.setSource(1, i, rotations[i * stackLayers + 1], translations[i * stackLayers + 1], t);
+    }
+
+    const double pairBlender = time([&] { pair.blend(); });
+    const double pairSlerp = time([&]
+    {
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            const auto* q = &rotations[i * stackLayers];
+            const auto* p = &translations[i * stackLayers];
+            const float t = weights[i * stackLayers];
+
+            expectedRotations[i] = slerp(q[0], q[1], t);
+            expectedTranslations[i] = lerp(p[0], p[1], t);
+        }
+    });
+    const auto pairResult = compare(pair, pairBlender, pairSlerp);
+
+    // All layers blended, against folding them in one at a time: each slerp
+    // moves towards the next layer by its share of the weight so far.
+    PoseBlender stack{n};
+    for(std::size_t k = 0; k < stackLayers; ++k)
+        stack.addLayer(PoseBlender::LayerMode::Blend);
+
+    for(std::size_t i = 0; i < n; ++i)
+        for(std::size_t k = 0; k < stackLayers; ++k)
+        {
+            const auto j = i * stackLayers + k;
+            stack.setSource(k, i, rotations[j], translations[j], weights[j]);
+        }
+
+    const double stackBlender = time([&] { stack.blend(); });
+    const double stackSlerp = time([&]
+    {
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            const auto j = i * stackLayers;
+            auto q = rotations[j];
+            auto p = translations[j];
+            float total = weights[j];
+
+            for(std::size_t k = 1; k < stackLayers; ++k)
+            {
+                total += weights[j + k];
+                const float share = weights[j + k] / total;
+
+                q = slerp(q, rotations[j + k], share);
+                p = lerp(p, translations[j + k], share);
+            }
+
+            expectedRotations[i] = q;
+            expectedTranslations[i] = p;
+        }
+    });
+    const auto stackResult = compare(stack, stackBlender, stackSlerp);
+
+    // Base, look-at and wobble, against a slerp towards the look-at and the
+    // wobble slerped in from identity.
+    PoseBlender stage{n};
+    const auto baseLayer = stage.addLayer(PoseBlender::LayerMode::Blend);
+    const auto lookAtLayer = stage.addLayer(PoseBlender::LayerMode::Blend);
+    const auto wobbleLayer = stage.addLayer(PoseBlender::LayerMode::Additive);
+
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        const auto j = i * stackLayers;
+        stage.setSource(baseLayer, i, rotations[j], translations[j], 1.f);
+        stage.setSource(lookAtLayer, i, rotations[j + 1], translations[j + 1], weights[j + 1]);
+        stage.setSource(wobbleLayer, i, wobbles[i], wobbleOffsets[i], weights[j + 2]);
+    }
+
+    const double stageBlender = time([&] { stage.blend(); });
+    const double stageSlerp = time([&]
+    {
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            const auto j = i * stackLayers;
+            const float lookAt = weights[j + 1] / (1.f + weights[j + 1]);
+            const float wobble = weights[j + 2];
+
+            expectedRotations[i] = slerp(rotations[j], rotations[j + 1], lookAt) * slerp(Quaternion{1.f}, wobbles[i], wobble);
+            expectedTranslations[i] = lerp(translations[j], translations[j + 1], lookAt) + wobbleOffsets[i] * wobble;
+        }
+    });
+    const auto stageResult = compare(stage, stageBlender, stageSlerp);
+
+    const auto print = [](const char* name, const Result& r, bool last)
+    {
+        std::cout << "  \"" << name << "\": {\"blenderNsPerActor\": " << r.blenderNs
+            << ", \"slerpNsPerActor\": " << r.slerpNs
+            << ", \"maxAngleDegrees\": " << r.maxAngle
+            << ", \"maxTranslation\": " << r.maxTranslation << "}"
+            << (last ? "\n" : ",\n");
+    };
+
+    std::cout << "{\n"
+        << "  \"actors\": " << n << ",\n"
+        << "  \"stackLayers\": " << stackLayers << ",\n";
+    print("pair", pairResult, false);
+    print("stack", stackResult, false);
+    print("stage", stageResult, false);
+    std::cout << "  \"checksum\": " << checksum << "\n}" << std::endl;
+
+    return 0;
+}
+
+// Times the three ways of getting from two poses to a model matrix over the
+// same random pose pairs and interpolation steps.
+static int runInterpolationBenchmark(std::size_t n)
+{
+    using namespace std::chrono;
+
+    constexpr int steps = 100;
+
+    std::vector<Quaternion> rotFrom(n), rotTo(n);
+    std::vector<Vector> locFrom(n), locTo(n);
+    std::vector<DualQuaternion> dqFrom(n), dqTo(n);
+
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        rotFrom[i] = getRandomOrientation();
+        rotTo[i] = getRandomOrientation();
+        locFrom[i] = getRandomLocation(100.f);
+        locTo[i] = getRandomLocation(100.f);
+        dqFrom[i] = DualQuaternion::fromRotationTranslation(rotFrom[i], locFrom[i]);
+        dqTo[i] = DualQuaternion::fromRotationTranslation(rotTo[i], locTo[i]);
+    }
+
+    std::vector<float> matrices(n * 16);
+    std::vector<float> ts(n);
+    double checksum{};
+
+    const auto measure = [&](const auto& body)
+    {
+        const auto start = steady_clock::now();
+
+        for(int step = 0; step <= steps; ++step)
+        {
+            std::fill(ts.begin(), ts.end(), float(step) / steps);
+            body();
+            checksum += matrices[(step * 16 + 12) % matrices.size()];
+        }
+
+        const double poses = double(std::max<std::size_t>(n, 1)) * (steps + 1);
+        return duration<double, std::nano>(steady_clock::now() - start).count() / poses;
+    };
+
+    const double separate = measure([&]
+    {
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            const auto m = makeModelMatrix(lerp(locFrom[i], locTo[i], ts[i]),
+                                           slerp(rotFrom[i], rotTo[i], ts[i]).getRotMatrix());
+            std::copy(m.begin(), m.end(), matrices.begin() + i * 16);
+        }
+    });
+
+    const double blend = measure([&]
+    {
+        dlbMatrices(dqFrom.data(), dqTo.data(), ts.data(), matrices.data(), n);
+    });
+
+    const double screw = measure([&]
+    {
+        for(std::size_t i = 0; i < n; ++i)
+            writeMatrix(sclerp(dqFrom[i], dqTo[i], ts[i]), matrices.data() + i * 16);
+    });
+
+    std::cout << "{\n"
+        << "  \"poses\": " << n << ",\n"
+        << "  \"steps\": " << steps + 1 << ",\n"
+        << "  \"nsPerPose\": {"
+        << "\"lerpSlerpMatrix\": " << separate
+        << ", \"dualQuaternionBlend\": " << blend
+        << ", \"screwLinear\": " << screw << "},\n"
+        << "  \"checksum\": " << checksum << "\n"
+        << "}" << std::endl;
+
+    return 0;
+}
+
+// Samples random motions at random times, once on this thread and once
+// spread over a pool with one thread per core.
+static int runSampleBenchmark(std::size_t n)
+{
+    using namespace std::chrono;
+
+    constexpr float extent = 100.f;
+
+    const auto sharedPath = std::make_shared<const Path>(std::vector<Vector>{
+        getRandomLocation(extent), getRandomLocation(extent), getRandomLocation(extent), getRandomLocation(extent)});
+
+    std::vector<MotionSpec> specs(n);
+    std::vector<float> ticks(n);
+
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        auto& spec = specs[i];
+        spec.rotStart = getRandomOrientation();
+        spec.rotEnd = getRandomOrientation();
+        spec.start = getRandomLocation(extent);
+        spec.end = getRandomLocation(extent);
+        spec.speed = Random::get().getRandomFloat(0.5f, 2.f);
+
+        // A quarter of the fleet flies the shared path, the rest a mix of modes.
+        if(i % 4 == 0)
+            spec.path = sharedPath;
+        else
+            spec.mode = static_cast<MotionMode>(i % 3);
+
+        ticks[i] = Random::get().getRandomFloat(0.f, getMotionDuration(spec));
+    }
+
+    std::vector<Pose> poses(n);
+    ThreadPool pool;
+
+    const auto measure = [&](ThreadPool* p)
+    {
+        const auto start = steady_clock::now();
+        sampleMotions(specs.data(), ticks.data(), poses.data(), n, p);
+        return double(n) / duration<double>(steady_clock::now() - start).count();
+    };
+
+    const double serial = measure(nullptr);
+    const double parallel = measure(&pool);
+
+    double checksum{};
+    for(std::size_t i = 0; i < n; i += 997)
+        checksum += poses[i].translation.X;
+
+    std::cout << "{\n"
+        << "  \"samples\": " << n << ",\n"
+        << "  \"threads\": " << pool.getThreadCount() << ",\n"
+        << "  \"samplesPerSecond\": {"
+        << "\"serial\": " << serial
+        << ", \"parallel\": " << parallel << "},\n"
+        << "  \"checksum\": " << checksum << "\n"
+        << "}" << std::endl;
+
+    return 0;
+}
+
+// Extrapolates autopilot-like motions from two consecutive ticks and
+// compares against the exact pose from the sampler, for growing horizons.
+// Holding the last pose is reported alongside as the baseline.
+static int runExtrapolationBenchmark(std::size_t n)
+{
+    constexpr float extent = 100.f;
+    constexpr float horizons[]{1.f, 2.f, 4.f, 8.f, 16.f, 32.f};
+    constexpr int samplesPerActor = 16;
+
+    struct Error
+    {
+        double position{};
+        double maxPosition{};
+        double angle{};
+        double maxAngle{};
+        double holdPosition{};
+        double holdAngle{};
+    };
+
+    std::array<Error, std::size(horizons)> errors{};
+
+    const auto angleBetween = [](const Quaternion& a, const Quaternion& b)
+    {
+        return 2.0 * toDegrees(std::acos(clamp(0.f, 1.f, std::abs(QuaternionDotProduct(a, b)))));
+    };
+
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        MotionSpec spec;
+        spec.rotStart = getRandomOrientation();
+        spec.rotEnd = getRandomOrientation();
+        spec.speed = Random::get().getRandomFloat(0.5f, 2.f);
+
+        if(i % 2 == 0)
+        {
+            spec.path = std::make_shared<const Path>(std::vector<Vector>{getRandomLocation(extent),
+                getRandomLocation(extent), getRandomLocation(extent)}, 64);
+        }
+        else
+        {
+            spec.start = getRandomLocation(extent);
+            spec.end = getRandomLocation(extent);
+        }
+
+        const float duration = getMotionDuration(spec);
+
+        for(int s = 0; s < samplesPerActor; ++s)
+        {
+            const float tick = Random::get().getRandomFloat(1.f, duration);
+            const auto current = sampleMotion(spec, tick);
+            const auto velocity = estimateVelocity(sampleMotion(spec, tick - 1.f), current, 1.f);
+
+            for(std::size_t h = 0; h < std::size(horizons); ++h)
+            {
+                // Past the end the motion stops, which no extrapolation can know.
+                const float target = std::min(tick + horizons[h], duration);
+                const auto truth = sampleMotion(spec, target);
+                const auto predicted = extrapolatePose(current, velocity, target - tick);
+
+                const double position = (predicted.translation - truth.translation).length();
+                const double angle = angleBetween(predicted.rotation, truth.rotation);
+
+                auto& e = errors[h];
+                e.position += position;
+                e.maxPosition = std::max(e.maxPosition, position);
+                e.angle += angle;
+                e.maxAngle = std::max(e.maxAngle, angle);
+                e.holdPosition += (current.translation - truth.translation).length();
+                e.holdAngle += angleBetween(current.rotation, truth.rotation);
+            }
+        }
+    }
+
+    const double samples = double(std::max<std::size_t>(n, 1)) * samplesPerActor;
+
+    std::cout << "{\n"
+        << "  \"actors\": " << n << ",\n"
+        << "  \"samplesPerHorizon\": " << n * samplesPerActor << ",\n"
+        << "  \"horizons\": [\n";
+
+    for(std::size_t h = 0; h < std::size(horizons); ++h)
+    {
+        const auto& e = errors[h];
+
+        std::cout << "    {\"ticks\": " << horizons[h]
+            << ", \"meanPosition\": " << e.position / samples
+            << ", \"maxPosition\": " << e.maxPosition
+            << ", \"meanAngleDeg\": " << e.angle / samples
+            << ", \"maxAngleDeg\": " << e.maxAngle
+            << ", \"holdMeanPosition\": " << e.holdPosition / samples
+            << ", \"holdMeanAngleDeg\": " << e.holdAngle / samples << "}"
+            << (h + 1 < std::size(horizons) ? ",\n" : "\n");
+    }
+
+    std::cout << "  ]\n}" << std::endl;
+
+    return 0;
+}
+
+// Loads and unloads the same number of spacecraft once with an individual
+// heap allocation per actor and once from a scene arena.
+static int runSceneBenchmark(std::size_t n)
+{
+    using namespace std::chrono;
+
+    std::vector<Vector> locations(n);
+    for(auto& location : locations)
+        location = getRandomLocation(100.f);
+
+    struct Result
+    {
+        double loadMs;
+        double unloadMs;
+        std::uint64_t loadAllocations;
+        std::uint64_t unloadAllocations;
+    };
+
+    const auto measure = [](const auto& load, const auto& unload)
+    {
+        Result r;
+
+        auto allocations = getAllocationCount();
+        auto start = steady_clock::now();
+        load();
+        r.loadMs = duration<double, std::milli>(steady_clock::now() - start).count();
+        r.loadAllocations = getAllocationCount() - allocations;
+
+        allocations = getAllocationCount();
+        start = steady_clock::now();
+        unload();
+        r.unloadMs = duration<double, std::milli>(steady_clock::now() - start).count();
+        r.unloadAllocations = getAllocationCount() - allocations;
+
+        return r;
+    };
+
+    std::vector<std::unique_ptr<Actor>> heapActors;
+    const auto heap = measure([&]
+    {
+        heapActors.reserve(n);
+        for(const auto& location : locations)
+            heapActors.push_back(std::make_unique<Spacecraft>(Transform{location}));
+    },
+    [&]
+    {
+        heapActors.clear();
+        heapActors.shrink_to_fit();
+    });
+
+    Scene arenaScene;
+    const auto arena = measure([&]
+    {
+        arenaScene.reserve(n);
+        for(const auto& location : locations)
+            arenaScene.spawn<Spacecraft>(Transform{location});
+    },
+    [&]
+    {
+        arenaScene.clear();
+    });
+
+    const auto print = [](const char* name, const Result& r, bool last)
+    {
+        std::cout << "  \"" << name << "\": {"
+            << "\"loadMs\": " << r.loadMs
+            << ", \"unloadMs\": " << r.unloadMs
+            << ", \"loadAllocations\": " << r.loadAllocations
+            << ", \"unloadAllocations\": " << r.unloadAllocations << "}"
+            << (last ? "\n" : ",\n");
+    };
+
+    std::cout << "{\n"
+        << "  \"actors\": " << n << ",\n"
+        << "  \"actorBytes\": " << sizeof(Spacecraft) << ",\n";
+    print("heap", heap, false);
+    print("arena", arena, true);
+    std::cout << "}" << std::endl;
+
+    return 0;
+}
+
+// Patrol script of the script benchmark: fly there, hold, fly back, hold.
+static MotionScript patrol(ScriptScheduler& s, MotionTrack& track, MotionSpec there, std::uint64_t hold)
+{
+    MotionSpec back = there;
+    std::swap(back.rotStart, back.rotEnd);
+    std::swap(back.start, back.end);
+
+    for(;;)
+    {
+        co_await s.play(track, there);
+        co_await s.wait(hold);
+        co_await s.play(track, back);
+        co_await s.wait(hold);
+    }
+}
+
+// Runs the same patrol for every agent as coroutine scripts and as a
+// per-agent state machine polled each tick, and compares the cost per tick.
+static int runScriptBenchmark(std::size_t n)
+{
+    using namespace std::chrono;
+
+    constexpr float extent = 100.f;
+    constexpr std::uint64_t ticks = 600;
+
+    std::vector<MotionSpec> motions(n);
+    std::vector<std::uint64_t> holds(n);
+
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        auto& motion = motions[i];
+        motion.rotStart = getRandomOrientation();
+        motion.rotEnd = getRandomOrientation();
+        motion.start = getRandomLocation(extent);
+        motion.end = getRandomLocation(extent);
+        motion.speed = Random::get().getRandomFloat(0.5f, 2.f);
+        motion.mode = static_cast<MotionMode>(i % 3);
+
+        holds[i] = 30 + i % 91;
+    }
+
+    // Coroutines
+    std::vector<MotionTrack> tracks(n);
+    ScriptScheduler scheduler;
+    scheduler.reserve(n);
+
+    auto allocations = getAllocationCount();
+    auto start = steady_clock::now();
+
+    for(std::size_t i = 0; i < n; ++i)
+        scheduler.start(patrol(scheduler, tracks[i], motions[i], holds[i]));
+
+    const double spawnMs = duration<double, std::milli>(steady_clock::now() - start).count();
+    const auto spawnAllocations = getAllocationCount() - allocations;
+    const auto pool = getScriptFramePoolStats();
+
+    std::uint64_t scriptResumes{};
+    allocations = getAllocationCount();
+    start = steady_clock::now();
+
+    for(std::uint64_t t = 0; t < ticks; ++t)
+    {
+        scheduler.tick();
+        scriptResumes += scheduler.getResumedCount();
+    }
+
+    const double scriptMs = duration<double, std::milli>(steady_clock::now() - start).count();
+    const auto scriptAllocations = getAllocationCount() - allocations;
+
+    // The same patrol as a hand-rolled state machine.
+    struct Patrol
+    {
+        unsigned step;
+        std::uint64_t wakeTick;
+    };
+
+    std::vector<MotionTrack> polledTracks(n);
+    std::vector<Patrol> patrols(n, Patrol{3, 0});
+    std::uint64_t polledResumes{};
+
+    const auto startMotion = [&](std::size_t i, std::uint64_t now, bool back)
+    {
+        auto& track = polledTracks[i];
+        track.spec = motions[i];
+
+        if(back)
+        {
+            std::swap(track.spec.rotStart, track.spec.rotEnd);
+            std::swap(track.spec.start, track.spec.end);
+        }
+
+        track.startTick = now;
+        track.endTick = now + std::uint64_t(std::ceil(getMotionDuration(track.spec)));
+        return track.endTick;
+    };
+
+    start = steady_clock::now();
+
+    for(std::uint64_t now = 0; now <= ticks; ++now)
+    {
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            auto& p = patrols[i];
+
+            if(now < p.wakeTick)
+                continue;
+
+            p.step = (p.step + 1) % 4;
+            p.wakeTick = p.step % 2 == 0 ? startMotion(i, now, p.step == 2) : now + holds[i];
+            ++polledResumes;
+        }
+    }
+
+    const double pollMs = duration<double, std::milli>(steady_clock::now() - start).count();
+
+    start = steady_clock::now();
+    scheduler.clear();
+    const double clearMs = duration<double, std::milli>(steady_clock::now() - start).count();
+
+    double checksum{};
+    for(std::size_t i = 0; i < n; i += 997)
+        checksum += tracks[i].sample(scheduler.getNow()).translation.X;
+
+    std::cout << "{\n"
+        << "  \"scripts\": " << n << ",\n"
+        << "  \"ticks\": " << ticks << ",\n"
+        << "  \"spawn\": {\"ms\": " << spawnMs
+        << ", \"allocations\": " << spawnAllocations
+        << ", \"poolChunks\": " << pool.chunks
+        << ", \"poolBytes\": " << pool.reservedBytes
+        << ", \"heapFrames\": " << pool.heapFallbacks << "},\n"
+        << "  \"coroutines\": {\"msPerTick\": " << scriptMs / ticks
+        << ", \"resumesPerTick\": " << double(scriptResumes) / ticks
+        << ", \"allocations\": " << scriptAllocations << "},\n"
+        << "  \"polling\": {\"msPerTick\": " << pollMs / (ticks + 1)
+        << ", \"transitionsPerTick\": " << double(polledResumes) / (ticks + 1) << "},\n"
+        << "  \"clearMs\": " << clearMs << ",\n"
+        << "  \"checksum\": " << checksum << "\n"
+        << "}" << std::endl;
+
+    return 0;
+}
+
+// Actors repeating a skewed mix of a few hundred maneuvers, sampled every
+// frame directly and through motion caches with a large and a tight
+// budget. Each actor looks its maneuver up again whenever it restarts.
+static int runMotionCacheBenchmark(std::size_t n)
+{
+    using namespace std::chrono;
+
+    constexpr float extent = 100.f;
+    constexpr std::size_t maneuvers = 256;
+    constexpr std::uint64_t frames = 300;
+
+    std::vector<MotionSpec> specs(maneuvers);
+    std::vector<std::uint64_t> lengths(maneuvers);
+    std::size_t bakedBytes{};
+
+    for(std::size_t i = 0; i < maneuvers; ++i)
+    {
+        auto& spec = specs[i];
+        spec.rotStart = getRandomOrientation();
+        spec.rotEnd = getRandomOrientation();
+        spec.start = getRandomLocation(extent);
+        spec.end = getRandomLocation(extent);
+        spec.speed = Random::get().getRandomFloat(0.5f, 2.f);
+        spec.mode = static_cast<MotionMode>(i % 3);
+
+        lengths[i] = std::uint64_t(std::ceil(getMotionDuration(spec))) + 1;
+        bakedBytes += BakedMotion{spec, 1.f}.getBytes();
+    }
+
+    // A few maneuvers are flown by most actors.
+    std::vector<std::size_t> maneuver(n);
+    std::vector<std::uint64_t> phase(n);
+
+    for(std::size_t a = 0; a < n; ++a)
+    {
+        const float u = Random::get().getRandomFloat(0.f, 1.f);
+        maneuver[a] = std::min(maneuvers - 1, std::size_t(float(maneuvers) * u * u * u));
+        phase[a] = std::uint64_t(Random::get().getRandomFloat(0.f, float(lengths[maneuver[a]])));
+    }
+
+    struct Result
+    {
+        double nsPerSample;
+        MotionCacheStats stats;
+    };
+
+    double checksum{};
+
+    const auto run = [&](MotionCache* cache)
+    {
+        std::vector<std::shared_ptr<const BakedMotion>> baked(n);
+
+        const auto start = steady_clock::now();
+
+        for(std::uint64_t frame = 0; frame < frames; ++frame)
+        {
+            for(std::size_t a = 0; a < n; ++a)
+            {
+                const auto m = maneuver[a];
+                const auto tick = (phase[a] + frame) % lengths[m];
+
+                Pose pose;
+
+                if(cache == nullptr)
+                    pose = sampleMotion(specs[m], float(tick));
+                else
+                {
+                    if(tick == 0 || frame == 0)
+                        baked[a] = cache->get(specs[m]);
+
+                    pose = baked[a] ? baked[a]->sample(float(tick)) : sampleMotion(specs[m], float(tick));
+                }
+
+                checksum += pose.translation.X;
+            }
+        }
+
+        const double ns = duration<double, std::nano>(steady_clock::now() - start).count();
+        return Result{ns / double(n * frames), cache ? cache->getStats() : MotionCacheStats{}};
+    };
+
+    const auto direct = run(nullptr);
+
+    MotionCache large{bakedBytes * 2};
+    const auto cached = run(&large);
+
+    MotionCache tight{bakedBytes / 8};
+    const auto constrained = run(&tight);
+
+    // Between table entries the cache interpolates; measure how far off
+    // that is at half ticks.
+    double maxPosition{};
+    double maxAngle{};
+
+    for(std::size_t i = 0; i < maneuvers; ++i)
+    {
+        const BakedMotion table{specs[i], 1.f};
+
+        for(std::uint64_t tick = 0; tick + 1 < lengths[i]; ++tick)
+        {
+            const float t = float(tick) + 0.5f;
+            const auto exact = sampleMotion(specs[i], t);
+            const auto approx = table.sample(t);
+
+            const auto d = exact.translation - approx.translation;
+            maxPosition = std::max(maxPosition, double(std::sqrt(d.X * d.X + d.Y * d.Y + d.Z * d.Z)));
+
+            const float dot = std::abs(QuaternionDotProduct(exact.rotation, approx.rotation));
+            maxAngle = std::max(maxAngle, 2.0 * toDegrees(std::acos(clamp(0.f, 1.f, dot))));
+        }
+    }
+
+    const auto print = [](const char* name, const Result& r, bool last)
+    {
+        std::cout << "  \"" << name << "\": {\"nsPerSample\": " << r.nsPerSample;
+
+        if(r.stats.budget > 0)
+        {
+            std::cout << ", \"budgetBytes\": " << r.stats.budget
+                << ", \"bytes\": " << r.stats.bytes
+                << ", \"entries\": " << r.stats.entries
+                << ", \"lookups\": " << r.stats.lookups
+                << ", \"hitRate\": " << r.stats.getHitRate()
+                << ", \"evictions\": " << r.stats.evictions;
+        }
+
+        std::cout << "}" << (last ? "\n" : ",\n");
+    };
+
+    std::cout << "{\n"
+        << "  \"actors\": " << n << ",\n"
+        << "  \"maneuvers\": " << maneuvers << ",\n"
+        << "  \"frames\": " << frames << ",\n"
+        << "  \"allManeuversBytes\": " << bakedBytes << ",\n"
+        << "  \"halfTickError\": {\"maxPosition\": " << maxPosition
+        << ", \"maxAngleDegrees\": " << maxAngle << "},\n";
+    print("direct", direct, false);
+    print("cached", cached, false);
+    print("tightBudget", constrained, false);
+    std::cout << "  \"checksum\": " << checksum << "\n}" << std::endl;
+
+    return 0;
+}
+
+// The matrix work of a frame: model matrices composed from poses, taken
+// through the view-projection one at a time the way the matrix stack
+// did and in one SIMD batch, plus the general inverse.
+static int runMatrixBenchmark(std::size_t n, const Camera& camera)
+{
+    using namespace std::chrono;
+
+    constexpr int repeats = 20;
+
+    std::vector<Pose> poses(n);
+    for(auto& pose : poses)
+        pose = {getRandomOrientation(), getRandomLocation(100.f), Random::get().getRandomFloat(0.5f, 2.f)};
+
+    const auto viewProjection = camera.getViewProjection();
+
+    std::vector<Matrix> models(n);
+    std::vector<Matrix> mvps(n);
+    double checksum{};
+
+    const auto time = [&](auto&& body)
+    {
+        const auto start = steady_clock::now();
+
+        for(int r = 0; r < repeats; ++r)
+        {
+            body();
+            checksum += mvps[r % n][0] + models[r % n][12];
+        }
+
+        return duration<double, std::nano>(steady_clock::now() - start).count() / double(n * repeats);
+    };
+
+    const double compose = time([&]
+    {
+        for(std::size_t i = 0; i < n; ++i)
+            models[i] = makeModelMatrix(poses[i]);
+    });
+
+    const double scalarMvp = time([&]
+    {
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            const auto& a = viewProjection;
+            const auto& b = models[i];
+            auto& r = mvps[i];
+
+            for(int col = 0; col < 4; ++col)
+                for(int row = 0; row < 4; ++row)
+                {
+                    float sum{};
+                    for(int k = 0; k < 4; ++k)
+                        sum += a[k * 4 + row] * b[col * 4 + k];
+                    r[col * 4 + row] = sum;
+                }
+        }
+    });
+
+    const double batchedMvp = time([&]
+    {
+        multiplyMatrices(viewProjection, models.data(), mvps.data(), n);
+    });
+
+    std::size_t singular{};
+
+    const double inverse = time([&]
+    {
+        for(std::size_t i = 0; i < n; ++i)
+            if(!invertMatrix(models[i], mvps[i]))
+                ++singular;
+    });
+
+    // m * inverse(m) against identity.
+    double maxError{};
+    const auto identity = identityMatrix();
+
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        const auto product = multiplyMatrices(models[i], mvps[i]);
+
+        for(int k = 0; k < 16; ++k)
+            maxError = std::max(maxError, double(std::abs(product[k] - identity[k])));
+    }
+
+    std::cout << "{\n"
+        << "  \"matrices\": " << n << ",\n"
+        << "  \"simd\": " << (isSimdEnabled() ? "true" : "false") << ",\n"
+        << "  \"nsPerMatrix\": {\"compose\": " << compose
+        << ", \"scalarMvp\": " << scalarMvp
+        << ", \"batchedMvp\": " << batchedMvp
+        << ", \"inverse\": " << inverse << "},\n"
+        << "  \"inverseMaxError\": " << maxError << ",\n"
+        << "  \"singular\": " << singular << ",\n"
+        << "  \"checksum\": " << checksum << "\n}" << std::endl;
+
+    return 0;
+}
+
+// Each Vector and Quaternion operation against its Vector4/Quaternion4
+// counterpart over arrays of random operands, with the largest difference
+// between the two results.
+static int runVectorBenchmark(std::size_t n)
+{
+    using namespace std::chrono;
+
+    constexpr int repeats = 20;
+
+    std::vector<Vector> a(n), b(n), out(n);
+    std::vector<Vector4> a4(n), b4(n), out4(n);
+    std::vector<Quaternion> p(n), q(n), outQ(n);
+    std::vector<Quaternion4> p4(n), q4(n), outQ4(n);
+    std::vector<float> dots(n), dots4(n);
+
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        a[i] = getRandomLocation(10.f);
+        b[i] = getRandomLocation(10.f);
+        // Off unit length, so normalizing has work to do.
+        p[i] = getRandomOrientation() * Random::get().getRandomFloat(0.5f, 2.f);
+        q[i] = getRandomOrientation();
+
+        a4[i] = Vector4{a[i]};
+        b4[i] = Vector4{b[i]};
+        p4[i] = Quaternion4{p[i]};
+        q4[i] = Quaternion4{q[i]};
+    }
+
+    const auto time = [&](auto&& body)
+    {
+        const auto start = steady_clock::now();
+
+        for(int r = 0; r < repeats; ++r)
+        {
+            body();
+            // Keeps the compiler from folding the identical passes into one.
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        }
+
+        return duration<double, std::nano>(steady_clock::now() - start).count() / double(n * repeats);
+    };
+
+    const auto vectorError = [&]
+    {
+        double e{};
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            const auto d = out[i] - out4[i].toVector();
+            e = std::max({e, double(std::abs(d.X)), double(std::abs(d.Y)), double(std::abs(d.Z))});
+        }
+        return e;
+    };
+
+    const auto quaternionError = [&]
+    {
+        double e{};
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            const auto r = outQ4[i].toQuaternion();
+            e = std::max({e, double(std::abs(outQ[i].w - r.w)), double(std::abs(outQ[i].x - r.x)),
+                double(std::abs(outQ[i].y - r.y)), double(std::abs(outQ[i].z - r.z))});
+        }
+        return e;
+    };
+
+    const auto dotError = [&]
+    {
+        double e{};
+        for(std::size_t i = 0; i < n; ++i)
+            e = std::max(e, double(std::abs(dots[i] - dots4[i])));
+        return e;
+    };
+
+    struct Result
+    {
+        const char* name;
+        double scalar;
+        double simd;
+        double maxError;
+    };
+
+    // Braced initialization runs left to right: both timings, then the
+    // comparison of their outputs.
+    const Result results[]{
+        {"add",
+            time([&] { for(std::size_t i = 0; i < n; ++i) { out[i] = a[i]; out[i] += b[i]; } }),
+            time([&] { for(std::size_t i = 0; i < n; ++i) { out4[i] = a4[i]; out4[i] += b4[i]; } }),
+            vectorError()},
+        {"dot",
+            time([&] { for(std::size_t i = 0; i < n; ++i) dots[i] = dotProduct(a[i], b[i]); }),
+            time([&] { for(std::size_t i = 0; i < n; ++i) dots4[i] = dotProduct(a4[i], b4[i]); }),
+            dotError()},
+        {"cross",
+            time([&] { for(std::size_t i = 0; i < n; ++i) out[i] = crossProduct(a[i], b[i]); }),
+            time([&] { for(std::size_t i = 0; i < n; ++i) out4[i] = crossProduct(a4[i], b4[i]); }),
+            vectorError()},
+        {"normalize",
+            time([&] { for(std::size_t i = 0; i < n; ++i) out[i] = normalize(a[i]); }),
+            time([&] { for(std::size_t i = 0; i < n; ++i) out4[i] = normalize(a4[i]); }),
+            vectorError()},
+        {"quaternionMultiply",
+            time([&] { for(std::size_t i = 0; i < n; ++i) outQ[i] = p[i] * q[i]; }),
+            time([&] { for(std::size_t i = 0; i < n; ++i) outQ4[i] = p4[i] * q4[i]; }),
+            quaternionError()},
+        {"quaternionDot",
+            time([&] { for(std::size_t i = 0; i < n; ++i) dots[i] = QuaternionDotProduct(p[i], q[i]); }),
+            time([&] { for(std::size_t i = 0; i < n; ++i) dots4[i] = QuaternionDotProduct(p4[i], q4[i]); }),
+            dotError()},
+        {"quaternionNormalize",
+            time([&] { for(std::size_t i = 0; i < n; ++i) outQ[i] = normalizeQuat(p[i]); }),
+            time([&] { for(std::size_t i = 0; i < n; ++i) outQ4[i] = normalizeQuat(p4[i]); }),
+            quaternionError()}
+    };
+
+    double checksum{};
+    for(std::size_t i = 0; i < n; ++i)
+        checksum += out[i].X + out4[i].x() + outQ[i].w + outQ4[i].w() + dots[i] + dots4[i];
+
+    std::cout << "{\n"
+        << "  \"count\": " << n << ",\n"
+        << "  \"simd\": " << (isSimdEnabled() ? "true" : "false") << ",\n"
+        << "  \"nsPerOp\": {\n";
+
+    for(const auto& r : results)
+    {
+        std::cout << "    \"" << r.name << "\": {\"scalar\": " << r.scalar
+            << ", \"simd\": " << r.simd
+            << ", \"maxError\": " << r.maxError << "}"
+            << (&r == &results[std::size(results) - 1] ? "\n" : ",\n");
+    }
+
+    std::cout << "  },\n"
+        << "  \"checksum\": " << checksum << "\n}" << std::endl;
+
+    return 0;
+}
+
+std::optional<int> LerpWithQuats::runBenchmark()
+{
+    if(options.blendBenchActors > 0)
+        return runBlendBenchmark(options.blendBenchActors);
+
+    if(options.interpolationBenchPoses > 0)
+        return runInterpolationBenchmark(options.interpolationBenchPoses);
+
+    if(options.sampleBenchCount > 0)
+        return runSampleBenchmark(options.sampleBenchCount);
+
+    if(options.extrapolationBenchActors > 0)
+        return runExtrapolationBenchmark(options.extrapolationBenchActors);
+
+    if(options.sceneBenchActors > 0)
+        return runSceneBenchmark(options.sceneBenchActors);
+
+    if(options.scriptBenchCount > 0)
+        return runScriptBenchmark(options.scriptBenchCount);
+
+    if(options.motionCacheBenchActors > 0)
+        return runMotionCacheBenchmark(options.motionCacheBenchActors);
+
+    if(options.matrixBenchCount > 0)
+        return runMatrixBenchmark(options.matrixBenchCount, camera);
+
+    if(options.vectorBenchCount > 0)
+        return runVectorBenchmark(options.vectorBenchCount);
+
+    if(options.benchFrames > 0)
+    {
+        initActors();
+        tp = std::chrono::steady_clock::now();
+
+        return runFrameBenchmark(options.benchFrames, tick, scene, scheduler, motionCache.get());
+    }
+
+    return std::nullopt;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Matrix.h"
+
+// Fixed camera of the scene. Its matrices are built on the CPU and handed to
+// GL already multiplied with each model matrix, and culling and LOD read the
+// same parameters.
+struct Camera
+{
+	Vector eye{0.f, 40.f, 40.f};
+	Vector center{};
+	Vector up{0.f, 1.f, 0.f};
+
+	float left{-5.f};
+	float right{5.f};
+	float bottom{-5.f};
+	float top{5.f};
+	float zNear{5.f};
+	float zFar{250.f};
+
+	Matrix getProjection() const noexcept
+	{
+		return frustumMatrix(left, right, bottom, top, zNear, zFar);
+	}
+
+	Matrix getView() const noexcept
+	{
+		return lookAtMatrix(eye, center, up);
+	}
+
+	Matrix getViewProjection() const noexcept
+	{
+		return multiplyMatrices(getProjection(), getView());
+	}
+};
@@ -0,0 +1,24 @@
+#include "DeadReckoning.h"
+
+PoseVelocity estimateVelocity(const Pose& previous, const Pose& current, float dt)
+{
+    if(dt <= 0.f)
+        return {};
+
+    Quaternion delta = current.rotation * conjugateQuat(previous.rotation);
+    if(delta.w < 0.f)
+        delta = delta * -1.f;
+
+    const float inverseDt = 1.f / dt;
+
+    return {(current.translation - previous.translation) * inverseDt, quatLog(delta) * (2.f * inverseDt)};
+}
+
+Pose extrapolatePose(const Pose& pose, const PoseVelocity& velocity, float dt)
+{
+    Pose r = pose;
+    r.translation += velocity.linear * dt;
+    r.rotation = normalizeQuat(quatExp(velocity.angular * (0.5f * dt)) * pose.rotation);
+
+    return r;
+}
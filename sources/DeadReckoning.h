@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Pose.h"
+
+// Velocities of a pose, per unit of whatever time step they were estimated
+// over. Angular velocity is a world-space axis scaled by the rotation rate in
+// radians.
+struct PoseVelocity
+{
+	Vector linear{};
+	Vector angular{};
+};
+
+// Finite difference between two consecutive poses dt apart. The rotation
+// between them goes through quatLog, taking the shorter way round.
+PoseVelocity estimateVelocity(const Pose& previous, const Pose& current, float dt);
+
+// Pose dt after `pose` if the velocities stay constant: translation moves in
+// a straight line, rotation keeps spinning about a fixed axis (quatExp).
+Pose extrapolatePose(const Pose& pose, const PoseVelocity& velocity, float dt);
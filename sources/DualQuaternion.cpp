@@ -0,0 +1,89 @@
+#include "DualQuaternion.h"
+#include <cmath>
+
+DualQuaternion dlb(const DualQuaternion& from, const DualQuaternion& to, float t)
+{
+    const float a = 1.f - t;
+    const float b = QuaternionDotProduct(from.real, to.real) < 0.f ? -t : t;
+
+    return normalizeDualQuat({
+        {from.real.w * a + to.real.w * b, from.real.x * a + to.real.x * b,
+         from.real.y * a + to.real.y * b, from.real.z * a + to.real.z * b},
+        {from.dual.w * a + to.dual.w * b, from.dual.x * a + to.dual.x * b,
+         from.dual.y * a + to.dual.y * b, from.dual.z * a + to.dual.z * b}});
+}
+
+DualQuaternion sclerp(const DualQuaternion& from, const DualQuaternion& to, float t)
+{
+    DualQuaternion d = conjugate(from) * to;
+
+    if(d.real.w < 0.f)
+        d = {d.real * -1.f, d.dual * -1.f};
+
+    const float halfAngle = std::acos(clamp(-1.f, 1.f, d.real.w));
+    const float s = std::sin(halfAngle);
+
+    // No rotation between the two: the screw degenerates to a translation.
+    if(s < 1e-5f)
+        return normalizeDualQuat(from * DualQuaternion{Quaternion{1.f}, d.dual * t});
+
+    // Screw parameters: axis direction, moment, angle and pitch.
+    const Vector axis{d.real.x / s, d.real.y / s, d.real.z / s};
+    const float pitch = -2.f * d.dual.w / s;
+    const float c = std::cos(halfAngle);
+    const Vector moment = (Vector{d.dual.x, d.dual.y, d.dual.z} - axis * (pitch * 0.5f * c)) * (1.f / s);
+
+    const float newHalfAngle = halfAngle * t;
+    const float newPitch = pitch * t;
+    const float sinT = std::sin(newHalfAngle);
+    const float cosT = std::cos(newHalfAngle);
+
+    const Vector dualVector = moment * sinT + axis * (newPitch * 0.5f * cosT);
+
+    const DualQuaternion step{
+        {cosT, axis.X * sinT, axis.Y * sinT, axis.Z * sinT},
+        {-newPitch * 0.5f * sinT, dualVector.X, dualVector.Y, dualVector.Z}};
+
+    return from * step;
+}
+
+void writeMatrix(const DualQuaternion& dq, float* m)
+{
+    const float w = dq.real.w;
+    const float x = dq.real.x;
+    const float y = dq.real.y;
+    const float z = dq.real.z;
+
+    const float dw = dq.dual.w;
+    const float dx = dq.dual.x;
+    const float dy = dq.dual.y;
+    const float dz = dq.dual.z;
+
+    m[0] = w*w + x*x - y*y - z*z;
+    m[1] = 2.f*x*y + 2.f*w*z;
+    m[2] = 2.f*x*z - 2.f*w*y;
+    m[3] = 0.f;
+
+    m[4] = 2.f*x*y - 2.f*w*z;
+    m[5] = w*w - x*x + y*y - z*z;
+    m[6] = 2.f*y*z + 2.f*w*x;
+    m[7] = 0.f;
+
+    m[8] = 2.f*x*z + 2.f*w*y;
+    m[9] = 2.f*y*z - 2.f*w*x;
+    m[10] = w*w - x*x - y*y + z*z;
+    m[11] = 0.f;
+
+    // 2 * dual * conjugate(real), vector part.
+    m[12] = 2.f * (-dw*x + dx*w - dy*z + dz*y);
+    m[13] = 2.f * (-dw*y + dy*w - dz*x + dx*z);
+    m[14] = 2.f * (-dw*z + dz*w - dx*y + dy*x);
+    m[15] = 1.f;
+}
+
+void dlbMatrices(const DualQuaternion* from, const DualQuaternion* to, const float* t,
+                 float* matrices, std::size_t count)
+{
+    for(std::size_t i = 0; i < count; ++i)
+        writeMatrix(dlb(from[i], to[i], t[i]), matrices + i * 16);
+}
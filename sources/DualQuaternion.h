@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include "Utils.h"
+
+// Rigid transform as real + dual quaternion: real is the rotation, dual is
+// half the translation times the rotation. Interpolating it moves the actor
+// along a screw, rotating and translating about one axis, instead of sliding
+// and spinning independently.
+struct DualQuaternion
+{
+	DualQuaternion(const Quaternion& pReal = Quaternion{1.f}, const Quaternion& pDual = Quaternion{})
+		:
+		real{pReal},
+		dual{pDual}
+	{
+
+	}
+
+	static DualQuaternion fromRotationTranslation(const Quaternion& rotation, const Vector& translation)
+	{
+		return {rotation, Quaternion{0.f, translation.X, translation.Y, translation.Z} * rotation * 0.5f};
+	}
+
+	DualQuaternion operator*(const DualQuaternion& rhs) const noexcept
+	{
+		const Quaternion a = real * rhs.dual;
+		const Quaternion b = dual * rhs.real;
+
+		return {real * rhs.real, {a.w + b.w, a.x + b.x, a.y + b.y, a.z + b.z}};
+	}
+
+	Quaternion getRotation() const noexcept
+	{
+		return real;
+	}
+
+	Vector getTranslation() const noexcept
+	{
+		const Quaternion t = dual * Quaternion{real.w, -real.x, -real.y, -real.z};
+		return {t.x * 2.f, t.y * 2.f, t.z * 2.f};
+	}
+
+	Quaternion real;
+	Quaternion dual;
+};
+
+inline DualQuaternion conjugate(const DualQuaternion& dq)
+{
+	return {{dq.real.w, -dq.real.x, -dq.real.y, -dq.real.z},
+	        {dq.dual.w, -dq.dual.x, -dq.dual.y, -dq.dual.z}};
+}
+
+// Scales to a unit real part and removes the dual part's component along it,
+// which is what keeps the result a rigid transform.
+inline DualQuaternion normalizeDualQuat(const DualQuaternion& dq)
+{
+	const float inverseLength = 1.f / std::sqrt(QuaternionDotProduct(dq.real, dq.real));
+	const Quaternion real = dq.real * inverseLength;
+	const Quaternion dual = dq.dual * inverseLength;
+	const float d = QuaternionDotProduct(real, dual);
+
+	return {real, {dual.w - real.w * d, dual.x - real.x * d, dual.y - real.y * d, dual.z - real.z * d}};
+}
+
+// Dual quaternion linear blending: a weighted sum on the shorter arc,
+// normalized. Not constant speed, but cheap and very close for small steps.
+DualQuaternion dlb(const DualQuaternion& from, const DualQuaternion& to, float t);
+
+// Screw linear interpolation: constant angular and linear speed along the screw.
+DualQuaternion sclerp(const DualQuaternion& from, const DualQuaternion& to, float t);
+
+// Column-major rotation + translation, laid out for glMultMatrixf.
+void writeMatrix(const DualQuaternion& dq, float* matrix);
+
+// DLB for many actors at once, written straight into packed 16-float matrices.
+void dlbMatrices(const DualQuaternion* from, const DualQuaternion* to, const float* t,
+                 float* matrices, std::size_t count);
@@ -0,0 +1,95 @@
+#include "FramePacer.h"
+#include <cmath>
+#include <thread>
+
+FramePacer::FramePacer(double targetFps)
+:
+    period{},
+    deadline{Clock::now()},
+    lastPresented{},
+    hasPresented{},
+    intervals{},
+    nextSample{}
+{
+    setTargetFps(targetFps);
+}
+
+void FramePacer::setTargetFps(double fps)
+{
+    using namespace std::chrono;
+
+    period = fps > 0.0 ? duration_cast<Clock::duration>(duration<double>(1.0 / fps)) : Clock::duration::zero();
+    deadline = Clock::now();
+}
+
+double FramePacer::getTargetFps() const noexcept
+{
+    using namespace std::chrono;
+
+    return period == Clock::duration::zero() ? 0.0 : 1.0 / duration<double>(period).count();
+}
+
+FramePacer::Clock::duration FramePacer::getTimeUntilNextFrame() const
+{
+    const auto now = Clock::now();
+    return deadline > now ? deadline - now : Clock::duration::zero();
+}
+
+void FramePacer::waitForNextFrame()
+{
+    std::this_thread::sleep_until(deadline);
+
+    const auto now = Clock::now();
+    deadline += period;
+
+    if(deadline < now)
+        deadline = now + period;
+}
+
+void FramePacer::markFramePresented()
+{
+    using namespace std::chrono;
+
+    const auto now = Clock::now();
+
+    if(hasPresented)
+    {
+        const double ms = duration<double, std::milli>(now - lastPresented).count();
+
+        if(intervals.size() < maxSamples)
+            intervals.push_back(ms);
+        else
+            intervals[nextSample] = ms;
+
+        nextSample = (nextSample + 1) % maxSamples;
+    }
+
+    lastPresented = now;
+    hasPresented = true;
+}
+
+void FramePacer::resetTiming()
+{
+    hasPresented = false;
+    deadline = Clock::now();
+}
+
+FrameTimeStats FramePacer::getIntervalStats() const
+{
+    return FrameTimeStats::compute(intervals);
+}
+
+FrameTimeStats FramePacer::getJitterStats() const
+{
+    using namespace std::chrono;
+
+    const double target = duration<double, std::milli>(period).count();
+
+    std::vector<double> jitter;
+    jitter.reserve(intervals.size());
+
+    for(const auto interval : intervals)
+        jitter.push_back(std::abs(interval - target));
+
+    return FrameTimeStats::compute(std::move(jitter));
+}
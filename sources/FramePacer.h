@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+#include "FrameTimeStats.h"
+
+// Paces presented frames to a target rate by sleeping until a deadline on
+// steady_clock, and keeps the recent intervals between presented frames for
+// jitter statistics.
+struct FramePacer
+{
+	using Clock = std::chrono::steady_clock;
+
+	// 0 fps means unpaced: frames are due immediately.
+	explicit FramePacer(double targetFps = 60.0);
+
+	void setTargetFps(double fps);
+	double getTargetFps() const noexcept;
+
+	// Time left until the next frame is due, zero when it already is.
+	Clock::duration getTimeUntilNextFrame() const;
+
+	// Sleeps until the deadline and moves it one period on. A pacer that has
+	// fallen more than a period behind restarts from now rather than
+	// presenting a burst of frames to catch up.
+	void waitForNextFrame();
+
+	void markFramePresented();
+
+	// Forget the last presented frame, so the pause after an idle stretch is
+	// not counted as a slow frame.
+	void resetTiming();
+
+	// Milliseconds between presented frames, and their distance from the
+	// target period.
+	FrameTimeStats getIntervalStats() const;
+	FrameTimeStats getJitterStats() const;
+
+private:
+
+	static constexpr std::size_t maxSamples{4096};
+
+	Clock::duration period;
+	Clock::time_point deadline;
+	Clock::time_point lastPresented;
+	bool hasPresented;
+
+	// Ring of the latest intervals.
+	std::vector<double> intervals;
+	std::size_t nextSample;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+// Summary of a series of frame durations, in milliseconds.
+struct FrameTimeStats
+{
+	std::size_t count{};
+	double mean{};
+	double p50{};
+	double p95{};
+	double p99{};
+	double max{};
+
+	static FrameTimeStats compute(std::vector<double> samples)
+	{
+		FrameTimeStats r;
+		if (samples.empty()) return r;
+
+		std::sort(samples.begin(), samples.end());
+
+		const auto at = [&samples](double p)
+		{
+			const auto i = static_cast<std::size_t>(p * double(samples.size() - 1) + 0.5);
+			return samples[i];
+		};
+
+		double sum{};
+		for (const auto s : samples)
+			sum += s;
+
+		r.count = samples.size();
+		r.mean = sum / double(samples.size());
+		r.p50 = at(0.5);
+		r.p95 = at(0.95);
+		r.p99 = at(0.99);
+		r.max = samples.back();
+
+		return r;
+	}
+};
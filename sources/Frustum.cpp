@@ -0,0 +1,76 @@
+#include "Frustum.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LWQ_FRUSTUM_SSE 1
+#endif
+
+Frustum Frustum::fromMatrix(const Matrix& m)
+{
+    Frustum r;
+
+    const auto row = [&m](int i, int k)
+    {
+        return m[k * 4 + i];
+    };
+
+    for (int p = 0; p < 6; ++p)
+    {
+        const int axis = p / 2;
+        const float sign = (p % 2 == 0) ? 1.f : -1.f;
+
+        auto& plane = r.planes[p];
+        for (int k = 0; k < 4; ++k)
+            plane[k] = row(3, k) + sign * row(axis, k);
+
+        const float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        for (auto& v : plane)
+            v /= length;
+    }
+
+    return r;
+}
+
+void Frustum::cullSpheres(const float* x, const float* y, const float* z, const float* radius,
+    std::size_t count, std::uint8_t* visible) const
+{
+    std::size_t i{};
+
+#ifdef LWQ_FRUSTUM_SSE
+    for (; i + 4 <= count; i += 4)
+    {
+        const auto px = _mm_loadu_ps(x + i);
+        const auto py = _mm_loadu_ps(y + i);
+        const auto pz = _mm_loadu_ps(z + i);
+        const auto negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+        auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+        for (const auto& plane : planes)
+        {
+            auto d = _mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(plane[0])), _mm_mul_ps(py, _mm_set1_ps(plane[1])));
+            d = _mm_add_ps(d, _mm_mul_ps(pz, _mm_set1_ps(plane[2])));
+            d = _mm_add_ps(d, _mm_set1_ps(plane[3]));
+
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negRadius));
+        }
+
+        const int mask = _mm_movemask_ps(inside);
+        for (int k = 0; k < 4; ++k)
+            visible[i + k] = static_cast<std::uint8_t>((mask >> k) & 1);
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        bool inside{true};
+
+        for (const auto& plane : planes)
+        {
+            const float d = plane[0] * x[i] + plane[1] * y[i] + plane[2] * z[i] + plane[3];
+            inside = inside && (d >= -radius[i]);
+        }
+
+        visible[i] = inside;
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "Camera.h"
+
+struct Frustum
+{
+	// Extracts the six clip planes of a column-major view-projection matrix.
+	static Frustum fromMatrix(const Matrix& viewProjection);
+
+	// Sets visible[i] to 1 when sphere i intersects the frustum, 0 otherwise.
+	// Spheres are given as separate coordinate arrays and tested four at a
+	// time with SSE2 when it is available.
+	void cullSpheres(const float* x, const float* y, const float* z, const float* radius,
+		std::size_t count, std::uint8_t* visible) const;
+
+	// Planes as (a, b, c, d) with unit inward normals: a*x + b*y + c*z + d >= 0
+	// inside. Order: left, right, bottom, top, near, far.
+	std::array<std::array<float, 4>, 6> planes;
+};
@@ -0,0 +1,41 @@
+#include "GpuMeshCache.h"
+
+const GpuMesh& GpuMeshCache::get(const MeshKey& key)
+{
+    const auto it = meshes.find(key);
+    if (it != meshes.end()) return it->second;
+
+    const auto& mesh = meshCache.get(key);
+
+    GpuMesh r;
+    glGenBuffers(1, &r.vertexBuffer);
+    glGenBuffers(1, &r.indexBuffer);
+
+    glBindBuffer(GL_ARRAY_BUFFER, r.vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, mesh.positions.size() * sizeof(float), mesh.positions.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, r.indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(std::uint32_t), mesh.indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    r.indexCount = static_cast<GLsizei>(mesh.indices.size());
+
+    return meshes.emplace(key, r).first->second;
+}
+
+void GpuMeshCache::drawImmediate(const MeshKey& key)
+{
+    const auto& mesh = get(key);
+
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.indexBuffer);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, nullptr);
+    glDrawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, nullptr);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <map>
+#include <GL/glew.h>
+#include "MeshCache.h"
+
+struct GpuMesh
+{
+	GLuint vertexBuffer{};
+	GLuint indexBuffer{};
+	GLsizei indexCount{};
+};
+
+// Uploads each mesh of a MeshCache into a vertex and an index buffer the
+// first time it is requested. GL thread only.
+struct GpuMeshCache
+{
+	explicit GpuMeshCache(MeshCache& pMeshCache)
+		:
+		meshCache{pMeshCache}
+	{
+
+	}
+
+	const GpuMesh& get(const MeshKey& key);
+
+	// Draws with the fixed-function vertex array, for contexts without the
+	// instanced path.
+	void drawImmediate(const MeshKey& key);
+
+	std::size_t getUploadCount() const noexcept
+	{
+		return meshes.size();
+	}
+
+private:
+
+	MeshCache& meshCache;
+	std::map<MeshKey, GpuMesh> meshes;
+};
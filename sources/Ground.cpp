@@ -2,25 +2,27 @@
 
 void Ground::tick(float deltaTime)
 {
-    glPushMatrix();
 
-    const float width = transform.scale.X;
-    const float height = transform.scale.Y;
+}
 
-    glColor3f(1.0, 0, 0);
-    glTranslatef(0.f, -15.f, 0.f);
-    glScalef(width, 1.f, height);
-    glutSolidCube(1.f);
+void Ground::draw(RenderSnapshot& snapshot) const
+{
+    const float width = size.X;
+    const float height = size.Y;
 
-    glPopMatrix();
+    snapshot.items.push_back(makeRenderItem(
+        MeshType::Cube,
+        {1.f, 0.f, 0.f},
+        composeMatrix({0.f, -15.f, 0.f}, Quaternion{1.f}, {width, 1.f, height})
+    ));
 }
 
-void Ground::setTransform(const Transform &newTransform)
+void Ground::setPose(const Pose& newPose)
 {
-    transform = newTransform;
+    pose = newPose;
 }
 
-Transform Ground::getTransform() const
+Pose Ground::getPose() const
 {
-    return transform;
+    return pose;
 }
\ No newline at end of file
@@ -4,19 +4,32 @@
 
 struct Ground : Actor
 {
-	explicit Ground(const Transform& pTransform)
+	explicit Ground(const Transform& pTransform,
+		std::pmr::memory_resource* resource = std::pmr::get_default_resource())
 		:
-		transform{pTransform}
+		Actor{resource},
+		pose{toPose(pTransform)},
+		size{pTransform.scale}
 	{
-
+		pose.scale = 1.f;
 	}
 
 	void tick(float deltaTime) override;
-	void setTransform(const Transform& newTransform) override;
-	Transform getTransform() const override;
+
+	bool isDormant() const override
+	{
+		return true;
+	}
+
+	void draw(RenderSnapshot& snapshot) const override;
+	void setPose(const Pose& newPose) override;
+	Pose getPose() const override;
 
 private:
 
-	Transform transform;
+	Pose pose;
+
+	// Width and depth of the plane; a Pose only carries a uniform scale.
+	Vector size;
 };
 	
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+// A keyboard event captured by a GLUT callback on the render thread and
+// replayed on the simulation thread. The timestamp is steady_clock
+// nanoseconds at capture, for measuring input latency.
+struct InputEvent
+{
+	enum class Type
+	{
+		KeyDown,
+		KeyUp,
+		SpecialDown,
+		SpecialUp
+	};
+
+	Type type;
+	int key;
+	int x;
+	int y;
+	std::int64_t timestamp{};
+};
@@ -0,0 +1,284 @@
+#include "InstancedRenderer.h"
+
+constexpr GLuint positionLocation{0};
+constexpr GLuint mvpLocation{1};
+constexpr GLuint colorLocation{5};
+
+constexpr const char* instancedVertexShader = R"(
+#version 330 core
+layout(location = 0) in vec3 position;
+layout(location = 1) in mat4 instanceMvp;
+layout(location = 5) in vec4 instanceColor;
+
+out vec4 color;
+
+void main()
+{
+    color = instanceColor;
+    gl_Position = instanceMvp * vec4(position, 1.0);
+}
+)";
+
+constexpr const char* instancedFragmentShader = R"(
+#version 330 core
+in vec4 color;
+out vec4 fragColor;
+
+void main()
+{
+    fragColor = color;
+}
+)";
+
+static GLuint compileShader(GLenum type, const char* source)
+{
+    const auto shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint status{};
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+
+    if (!status)
+    {
+        char log[1024]{};
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        std::cerr << "Instanced shader compilation failed: " << log << std::endl;
+
+        glDeleteShader(shader);
+        return 0;
+    }
+
+    return shader;
+}
+
+bool InstancedRenderer::init(GpuMeshCache& gpuMeshes, const MeshKeySet& keys)
+{
+    if (!GLEW_VERSION_3_3)
+    {
+        std::cerr << "GL 3.3 is not available, using immediate mode" << std::endl;
+        return false;
+    }
+
+    if (!buildProgram()) return false;
+
+    persistent = GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+
+    glGenBuffers(1, &instanceBuffer);
+
+    for (std::size_t i = 0; i < keys.size(); ++i)
+        batches[i] = makeBatch(gpuMeshes.get(keys[i]));
+
+    reserveInstances(1024);
+
+    ready = true;
+    return true;
+}
+
+bool InstancedRenderer::isReady() const noexcept
+{
+    return ready;
+}
+
+bool InstancedRenderer::isPersistentlyMapped() const noexcept
+{
+    return persistent;
+}
+
+bool InstancedRenderer::buildProgram()
+{
+    const auto vertexShader = compileShader(GL_VERTEX_SHADER, instancedVertexShader);
+    const auto fragmentShader = compileShader(GL_FRAGMENT_SHADER, instancedFragmentShader);
+
+    if (!vertexShader || !fragmentShader) return false;
+
+    program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    glLinkProgram(program);
+
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint status{};
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+
+    if (!status)
+    {
+        char log[1024]{};
+        glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+        std::cerr << "Instanced shader link failed: " << log << std::endl;
+
+        glDeleteProgram(program);
+        program = 0;
+        return false;
+    }
+
+    return true;
+}
+
+InstancedRenderer::Batch InstancedRenderer::makeBatch(const GpuMesh& mesh)
+{
+    Batch r;
+
+    glGenVertexArrays(1, &r.vao);
+    glBindVertexArray(r.vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vertexBuffer);
+    glEnableVertexAttribArray(positionLocation);
+    glVertexAttribPointer(positionLocation, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.indexBuffer);
+
+    for (GLuint i = 0; i < 4; ++i)
+    {
+        glEnableVertexAttribArray(mvpLocation + i);
+        glVertexAttribDivisor(mvpLocation + i, 1);
+    }
+    glEnableVertexAttribArray(colorLocation);
+    glVertexAttribDivisor(colorLocation, 1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    r.indexCount = mesh.indexCount;
+    return r;
+}
+
+void InstancedRenderer::reserveInstances(std::size_t count)
+{
+    if (count <= regionCapacity) return;
+
+    regionCapacity = std::max(count, regionCapacity * 2);
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+
+    if (persistent)
+    {
+        // Storage is immutable: the old buffer can only be replaced once the
+        // GPU is done with every region of it.
+        if (mapped != nullptr)
+        {
+            glFinish();
+
+            for (auto& fence : fences)
+            {
+                if (fence) glDeleteSync(fence);
+                fence = nullptr;
+            }
+
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            glDeleteBuffers(1, &instanceBuffer);
+            glGenBuffers(1, &instanceBuffer);
+            glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        }
+
+        const auto flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        const auto size = regionCount * regionCapacity * sizeof(InstanceData);
+
+        glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+        mapped = static_cast<InstanceData*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+        region = 0;
+    }
+    else
+    {
+        staging.reserve(regionCapacity);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstancedRenderer::bindInstanceAttributes(std::size_t firstInstance)
+{
+    const auto stride = static_cast<GLsizei>(sizeof(InstanceData));
+    const auto base = firstInstance * sizeof(InstanceData);
+
+    for (GLuint i = 0; i < 4; ++i)
+    {
+        const auto offset = base + offsetof(InstanceData, mvp) + i * 4 * sizeof(float);
+        glVertexAttribPointer(mvpLocation + i, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offset));
+    }
+
+    const auto colorOffset = base + offsetof(InstanceData, color);
+    glVertexAttribPointer(colorLocation, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(colorOffset));
+}
+
+std::size_t InstancedRenderer::draw(const RenderQueue& queue)
+{
+    const auto total = queue.getInstanceCount();
+    if (!ready || total == 0) return 0;
+
+    reserveInstances(total);
+
+    InstanceData* destination;
+    std::size_t regionStart{};
+
+    if (persistent)
+    {
+        auto& fence = fences[region];
+        if (fence)
+        {
+            while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+
+        regionStart = region * regionCapacity;
+        destination = mapped + regionStart;
+    }
+    else
+    {
+        staging.resize(total);
+        destination = staging.data();
+    }
+
+    std::array<std::size_t, meshTypeCount * lodTierCount> bucketStart{};
+    std::size_t written{};
+
+    for (std::size_t i = 0; i < queue.buckets.size(); ++i)
+    {
+        const auto& bucket = queue.buckets[i];
+
+        bucketStart[i] = regionStart + written;
+        std::copy(bucket.begin(), bucket.end(), destination + written);
+        written += bucket.size();
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+
+    if (!persistent)
+    {
+        glBufferData(GL_ARRAY_BUFFER, regionCapacity * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, total * sizeof(InstanceData), staging.data());
+    }
+
+    glUseProgram(program);
+
+    std::size_t drawCalls{};
+
+    for (std::size_t i = 0; i < queue.buckets.size(); ++i)
+    {
+        const auto count = queue.buckets[i].size();
+        const auto& batch = batches[i];
+
+        if (count == 0 || batch.vao == 0) continue;
+
+        glBindVertexArray(batch.vao);
+        bindInstanceAttributes(bucketStart[i]);
+        glDrawElementsInstanced(GL_TRIANGLES, batch.indexCount, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(count));
+
+        ++drawCalls;
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glUseProgram(0);
+
+    if (persistent)
+    {
+        fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        region = (region + 1) % regionCount;
+    }
+
+    return drawCalls;
+}
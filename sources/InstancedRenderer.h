@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include "GpuMeshCache.h"
+#include "RenderQueue.h"
+
+// Draws a RenderQueue with one glDrawElementsInstanced call per non-empty
+// bucket. Instance data goes through a persistently mapped buffer split into
+// three regions guarded by fences, so the CPU never writes a region the GPU
+// may still be reading. Without ARB_buffer_storage it falls back to orphaning
+// a regular buffer every frame.
+struct InstancedRenderer
+{
+	// Mesh drawn for each RenderQueue bucket.
+	using MeshKeySet = std::array<MeshKey, meshTypeCount * lodTierCount>;
+
+	// Needs a current GL context and an initialized GLEW. Returns false when
+	// the context lacks GL 3.3; the caller then keeps the immediate-mode path.
+	bool init(GpuMeshCache& gpuMeshes, const MeshKeySet& keys);
+	bool isReady() const noexcept;
+	bool isPersistentlyMapped() const noexcept;
+
+	// Returns the number of draw calls issued.
+	std::size_t draw(const RenderQueue& queue);
+
+private:
+
+	struct Batch
+	{
+		GLuint vao{};
+		GLsizei indexCount{};
+	};
+
+	static constexpr std::size_t regionCount{3};
+
+	bool buildProgram();
+	Batch makeBatch(const GpuMesh& mesh);
+	void reserveInstances(std::size_t count);
+	void bindInstanceAttributes(std::size_t firstInstance);
+
+	bool ready{};
+	bool persistent{};
+
+	GLuint program{};
+	std::array<Batch, meshTypeCount * lodTierCount> batches{};
+
+	GLuint instanceBuffer{};
+	std::size_t regionCapacity{};
+	InstanceData* mapped{};
+	std::array<GLsync, regionCount> fences{};
+	std::size_t region{};
+
+	std::vector<InstanceData> staging;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+
+// Which keys are held, one bit each. Ordinary keys and GLUT special keys have
+// separate ranges, so GLUT_KEY_UP (101) is not the same key as 'e'.
+struct KeyState
+{
+	static constexpr std::size_t keyCount{256};
+
+	void setKey(unsigned char key, bool down) noexcept
+	{
+		bits.set(key, down);
+	}
+
+	void setSpecial(int key, bool down) noexcept
+	{
+		if (key >= 0 && static_cast<std::size_t>(key) < keyCount)
+			bits.set(keyCount + key, down);
+	}
+
+	bool isKeyDown(unsigned char key) const noexcept
+	{
+		return bits.test(key);
+	}
+
+	bool isSpecialDown(int key) const noexcept
+	{
+		return key >= 0 && static_cast<std::size_t>(key) < keyCount && bits.test(keyCount + key);
+	}
+
+	bool any() const noexcept
+	{
+		return bits.any();
+	}
+
+private:
+
+	std::bitset<keyCount * 2> bits;
+};
@@ -1,17 +1,29 @@
 #include "LerpWithQuats.h"
 #include "Ground.h"
 #include "Spacecraft.h"
+#include "AllocationCounter.h"
+#include "FrameTimeStats.h"
+#include "OffscreenContext.h"
+#include <iomanip>
+#include <sstream>
+
+	static void writeBitmapString(void* font, const std::string& str)
+	{
+		for (const auto ch : str) glutBitmapCharacter(font, ch);
+	}
 
 	std::string makeLabelWithVal(const std::string& label, float val)
 	{
 		return label + std::to_string(val);
 	}
 
-	void LerpWithQuats::drawPlayerHUD()
+	void LerpWithQuats::drawPlayerHUD(const RenderSnapshot& snapshot)
 	{
+		// The labels sit in eye space; GL's own projection is identity.
+		glLoadMatrixf(camera.getProjection().data());
 		glColor3f(0.f, 0.f, 0.f);
 
-		const auto [alpha, beta, gamma] = spacecraft->getEulerAngles();
+		const auto [alpha, beta, gamma] = snapshot.hudAngles;
 
 		const auto alphaLabel = makeLabelWithVal("alpha: ", alpha);
 		const auto betaLabel = makeLabelWithVal("beta:  ", beta);
@@ -25,88 +37,498 @@
 
 		glRasterPos3d(2.8f, 3.4f, -5.f);
 		writeBitmapString(GLUT_BITMAP_9_BY_15, gammaLabel);
+
+		const auto& stats = renderer.getStats();
+		const auto cullLabel = "visible: " + std::to_string(stats.visible) +
+			" culled: " + std::to_string(stats.culled) +
+			" draws: " + std::to_string(stats.drawCalls);
+
+		glRasterPos3d(2.8f, 3.1f, -5.f);
+		writeBitmapString(GLUT_BITMAP_9_BY_15, cullLabel);
 	}
 
     void LerpWithQuats::tick()
 	{	
-		const float dist = 40.f;
-		glPushMatrix();
+		using namespace std::chrono;
+
+		// Step to step, on the monotonic clock and below a millisecond.
+		const auto now = steady_clock::now();
+		const duration<float, std::milli> d = now - tp;
+		deltaTime = d.count() / 1000.f;
+		tp = now;
+
+		const auto allocationsBefore = getAllocationCount();
+		const auto phaseStart = steady_clock::now();
+
+		drainInput();
+		const auto inputEnd = steady_clock::now();
+
+		scripts.tick();
+		const auto scriptsEnd = steady_clock::now();
+
+		scheduler.tick(framesProduced, deltaTime);
+		const auto tickEnd = steady_clock::now();
 
-		drawPlayerHUD();
+		recordFrame();
+		const auto recordEnd = steady_clock::now();
 
-		gluLookAt(0.f, dist, dist, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f);
+		auto& snapshot = snapshots.back();
+		snapshot.frame = framesProduced + 1;
+		snapshot.active = scheduler.anyTicked();
+		snapshot.hudAngles = spacecraft->getEulerAngles();
+		snapshot.items.clear();
 
-		for(const auto& actor : actors)
-			actor->tick(deltaTime);	
-		glPopMatrix();
+		// Actors of slow tick groups are drawn ahead to this frame, so they
+		// move every frame instead of jumping every few.
+		for(auto* actor : scene.getActors())
+			actor->drawAhead(snapshot, scheduler.getFramesSinceTick(*actor, framesProduced));
 
+		if(telemetry)
+		{
+			const auto ms = [](auto from, auto to)
+			{
+				return duration<float, std::milli>(to - from).count();
+			};
+
+			const auto snapshotEnd = steady_clock::now();
+
+			TelemetryFrame t;
+			t.frame = snapshot.frame;
+			t.timestampNs = duration_cast<nanoseconds>(snapshotEnd.time_since_epoch()).count();
+			t.frameMs = d.count();
+			t.stepMs = ms(phaseStart, snapshotEnd);
+			t.inputMs = ms(phaseStart, inputEnd);
+			t.scriptsMs = ms(inputEnd, scriptsEnd);
+			t.tickMs = ms(scriptsEnd, tickEnd);
+			t.recordMs = ms(tickEnd, recordEnd);
+			t.snapshotMs = ms(recordEnd, snapshotEnd);
+			t.actors = std::uint32_t(scene.size());
+
+			for(const auto& group : scheduler.getStats())
+			{
+				t.tickedActors += std::uint32_t(group.ticked);
+				t.sleepingActors += std::uint32_t(group.sleeping);
+			}
+
+			t.activeMotions = std::uint32_t(scripts.getScriptCount());
+			t.resumedScripts = std::uint32_t(scripts.getResumedCount());
+			t.renderItems = std::uint32_t(snapshot.items.size());
+			t.totalAllocations = getAllocationCount();
+			t.allocations = t.totalAllocations - allocationsBefore;
+
+			telemetry->publish(t);
+		}
+
+		snapshots.publish();
+		++framesProduced;
 	}
 
-	void LerpWithQuats::drawScene(void)
+	void LerpWithQuats::simulationLoop()
 	{
-		using namespace std::chrono;
+		tp = std::chrono::steady_clock::now();
+
+		while(simulationRunning.load(std::memory_order_acquire))
+		{
+			tick();
+
+			// Stay exactly one frame ahead of the render thread: frame N+1 is
+			// simulated while frame N is drawn, and no frame is skipped.
+			auto consumed = framesConsumed.load(std::memory_order_acquire);
+			while(consumed < framesProduced && simulationRunning.load(std::memory_order_acquire))
+			{
+				framesConsumed.wait(consumed, std::memory_order_acquire);
+				consumed = framesConsumed.load(std::memory_order_acquire);
+			}
+		}
+	}
+
+	void LerpWithQuats::startSimulation()
+	{
+		simulationRunning.store(true, std::memory_order_release);
+		simulationThread = std::thread(simulationLoop);
+	}
+
+	void LerpWithQuats::stopSimulation()
+	{
+		if(!simulationThread.joinable())
+			return;
+
+		simulationRunning.store(false, std::memory_order_release);
+		framesConsumed.fetch_add(1, std::memory_order_release);
+		framesConsumed.notify_one();
+
+		simulationThread.join();
+	}
+
+	// The state of the keys once an event is applied, as the spacecraft
+	// keeps it.
+	static void applyInputEvent(KeyState& keys, const InputEvent& event)
+	{
+		switch(event.type)
+		{
+		case InputEvent::Type::KeyDown:
+		case InputEvent::Type::KeyUp:
+			keys.setKey(static_cast<unsigned char>(event.key), event.type == InputEvent::Type::KeyDown);
+			break;
+		case InputEvent::Type::SpecialDown:
+		case InputEvent::Type::SpecialUp:
+			keys.setSpecial(event.key, event.type == InputEvent::Type::SpecialDown);
+			break;
+		}
+	}
+
+	void LerpWithQuats::postInput(InputEvent event)
+	{
+		applyInputEvent(heldKeys, event);
+
+		// The ring fills up while the simulation waits for this thread to
+		// draw, so waiting for room here would never end. Drop the event and
+		// send the keys it changed once there is room again.
+		if(inputDropped)
+			resyncInput();
+		else if(!pushInput(event))
+			inputDropped = true;
 
+		requestRedraw();
+	}
+
+	bool LerpWithQuats::pushInput(InputEvent event)
+	{
+		event.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+
+		if(!inputQueue.push(event))
+			return false;
+
+		applyInputEvent(sentKeys, event);
+		return true;
+	}
+
+	void LerpWithQuats::resyncInput()
+	{
+		for(int key = 0; key < int(KeyState::keyCount); ++key)
+		{
+			const auto k = static_cast<unsigned char>(key);
+
+			if(heldKeys.isKeyDown(k) != sentKeys.isKeyDown(k)
+				&& !pushInput({heldKeys.isKeyDown(k) ? InputEvent::Type::KeyDown : InputEvent::Type::KeyUp, key, 0, 0}))
+				return;
+
+			if(heldKeys.isSpecialDown(key) != sentKeys.isSpecialDown(key)
+				&& !pushInput({heldKeys.isSpecialDown(key) ? InputEvent::Type::SpecialDown : InputEvent::Type::SpecialUp, key, 0, 0}))
+				return;
+		}
+
+		inputDropped = false;
+	}
+
+	void LerpWithQuats::drainInput()
+	{
+		InputEvent event;
+
+		while(inputQueue.pop(event))
+		{
+			scheduler.wake(*spacecraft);
+
+			switch(event.type)
+			{
+			case InputEvent::Type::KeyDown:
+				spacecraft->keyInput(event.key, event.x, event.y);
+				break;
+			case InputEvent::Type::KeyUp:
+				spacecraft->keyInputUp(event.key, event.x, event.y);
+				break;
+			case InputEvent::Type::SpecialDown:
+				spacecraft->specialDownFunc(event.key, event.x, event.y);
+				break;
+			case InputEvent::Type::SpecialUp:
+				spacecraft->specialUpFunc(event.key, event.x, event.y);
+				break;
+			}
+		}
+	}
+
+	void LerpWithQuats::recordFrame()
+	{
+		if(recorder == nullptr)
+			return;
+
+		ReplayFrame frame;
+		frame.reserve(scene.size());
+
+		for(auto* actor : scene.getActors())
+		{
+			const auto pose = actor->getPose();
+			frame.push_back({pose.translation, {pose.scale, pose.scale, pose.scale}, pose.rotation});
+		}
+
+		recorder->record(std::move(frame));
+	}
+
+	int LerpWithQuats::dumpReplay()
+	{
+		ReplayReader reader{options.replayPath};
+
+		if(!reader.isOpen())
+			return 1;
+
+		std::cout << "frames: " << reader.getFrameCount()
+			<< " keyframe interval: " << reader.getKeyframeInterval() << '\n';
+
+		const auto first = options.replayFrame < 0 ? 0 : std::uint64_t(options.replayFrame);
+		const auto last = options.replayFrame < 0 ? reader.getFrameCount() : first + 1;
+
+		ReplayFrame frame;
+		for(auto n = first; n < last; ++n)
+		{
+			if(!reader.readFrame(n, frame))
+			{
+				std::cerr << "Can't read frame " << n << std::endl;
+				return 1;
+			}
+
+			std::cout << "frame " << n << '\n';
+			for(std::size_t i = 0; i < frame.size(); ++i)
+			{
+				const auto& q = frame[i].orientation;
+				std::cout << "  actor " << i << " translation " << frame[i].translation
+					<< " scale " << frame[i].scale
+					<< " orientation " << q.w << ' ' << q.x << ' ' << q.y << ' ' << q.z << '\n';
+			}
+		}
+
+		return 0;
+	}
+
+	bool LerpWithQuats::acquireSnapshot()
+	{
+		if(!snapshots.acquire())
+			return false;
+
+		framesConsumed.fetch_add(1, std::memory_order_release);
+		framesConsumed.notify_one();
+		return true;
+	}
+
+	void LerpWithQuats::renderScene(const RenderSnapshot& snapshot)
+	{
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		glLoadIdentity();
 
-		auto d = duration_cast<milliseconds>(system_clock::now() - tp);
-		deltaTime = float(d.count()) * milliseconds::period::num / milliseconds::period::den;
-		tp = system_clock::now();
+		renderer.draw(snapshot);
+	}
+
+	void LerpWithQuats::drawScene(void)
+	{
+		if(inputDropped)
+			resyncInput();
+
+		const bool fresh = acquireSnapshot();
+
+		const auto& snapshot = snapshots.front();
 
-		tick();
+		renderScene(snapshot);
+		drawPlayerHUD(snapshot);
 	
 		glutSwapBuffers();
+		pacer.markFramePresented();
+
+		// Keep drawing while the simulation reports movement or has not caught
+		// up yet; otherwise wait for input or a resize.
+		if(pendingRedraws > 0)
+			--pendingRedraws;
+
+		if(!fresh || snapshot.active || inputDropped)
+			pendingRedraws = std::max(pendingRedraws, 1);
+	}
+
+	int LerpWithQuats::runOffscreen()
+	{
+		using namespace std::chrono;
+
+		OffscreenContext context;
+
+		if(!context.create(options.width, options.height))
+			return 1;
+
+		std::cout << "Offscreen renderer: " << glGetString(GL_RENDERER) << ", " << glGetString(GL_VERSION) << '\n';
+
+		initScene();
+		resize(options.width, options.height);
+
+		std::vector<double> frameTimes;
+		frameTimes.reserve(options.offscreenFrames);
+
+		for(std::uint64_t frame = 0; frame < options.offscreenFrames; ++frame)
+		{
+			// Draw every simulated frame exactly once so dumps are reproducible.
+			while(!acquireSnapshot())
+				std::this_thread::yield();
+
+			const auto start = steady_clock::now();
+
+			renderScene(snapshots.front());
+			glFinish();
+
+			const auto end = steady_clock::now();
+			frameTimes.push_back(duration<double, std::milli>(end - start).count());
+
+			if(!options.dumpDirectory.empty())
+			{
+				std::ostringstream path;
+				path << options.dumpDirectory << "/frame" << std::setw(5) << std::setfill('0') << frame << ".ppm";
+
+				if(!context.writePpm(path.str()))
+					break;
+			}
+		}
+
+		stopSimulation();
+
+		const auto stats = FrameTimeStats::compute(frameTimes);
+		const auto& renderStats = renderer.getStats();
+
+		std::cout << "frames: " << stats.count
+			<< " render ms mean: " << stats.mean
+			<< " p50: " << stats.p50
+			<< " p95: " << stats.p95
+			<< " p99: " << stats.p99
+			<< " max: " << stats.max << '\n'
+			<< "last frame visible: " << renderStats.visible
+			<< " culled: " << renderStats.culled
+			<< " draws: " << renderStats.drawCalls << std::endl;
+
+		return 0;
 	}
 
+	// Frame pacing on the GLUT thread: a coarse timer gets close to the
+	// deadline, sleep_until on steady_clock hits it. With nothing changing the
+	// timer is not re-armed at all, so an idle scene costs no CPU until
+	// requestRedraw().
 	void LerpWithQuats::animate(int value)
 	{
+		using namespace std::chrono;
+
+		if(!options.continuousRedraw && pendingRedraws == 0)
+		{
+			animating = false;
+			return;
+		}
+
+		const auto wait = duration_cast<milliseconds>(pacer.getTimeUntilNextFrame());
+		if(wait > milliseconds{2})
+		{
+			glutTimerFunc(static_cast<unsigned>(wait.count() - 1), animate, 1);
+			return;
+		}
+
+		pacer.waitForNextFrame();
 		glutPostRedisplay();
-		glutTimerFunc(animationPeriod, animate, 1);
+		glutTimerFunc(0, animate, 1);
+	}
+
+	void LerpWithQuats::requestRedraw()
+	{
+		// The simulation runs a frame ahead, so the frame already in flight
+		// predates the event; the one after it shows it.
+		pendingRedraws = 2;
+
+		if(!animating)
+		{
+			animating = true;
+			pacer.resetTiming();
+			glutTimerFunc(0, animate, 1);
+		}
+	}
+
+	void LerpWithQuats::printFramePacing()
+	{
+		const auto intervals = pacer.getIntervalStats();
+		const auto jitter = pacer.getJitterStats();
+
+		std::cout << "Frame pacing (target " << pacer.getTargetFps() << " fps, last " << intervals.count << " frames):\n"
+			<< "  interval ms mean " << intervals.mean << " p50 " << intervals.p50
+			<< " p95 " << intervals.p95 << " p99 " << intervals.p99 << " max " << intervals.max << '\n'
+			<< "  jitter ms   mean " << jitter.mean << " p50 " << jitter.p50
+			<< " p95 " << jitter.p95 << " p99 " << jitter.p99 << " max " << jitter.max << std::endl;
 	}
 
-	std::unique_ptr<Ground> createGround()
+	Ground& createGround(Scene& scene)
 	{
-		return std::make_unique<Ground>(
+		return scene.spawn<Ground>(
 			Transform{{}, {100.f, 100.f, 1.f}}
 		);
 	}
 
-	std::unique_ptr<Spacecraft> createSpacecraft()
+	Spacecraft& createSpacecraft(Scene& scene)
 	{
-		return std::make_unique<Spacecraft>(
+		return scene.spawn<Spacecraft>(
 			Transform{{0.f, 5.f, 0.f}}
 		);
 	}
 
-	void LerpWithQuats::initActors()
-	{	
-		auto freshSpacecraft = createSpacecraft();
+	static void spawnStressFleet(Scene& scene, std::size_t count)
+	{
+		constexpr float fleetExtent = 100.f;
 
-		if(freshSpacecraft == nullptr)
+		scene.reserve(scene.size() + count);
+
+		for(std::size_t i = 0; i < count; ++i)
 		{
-			std::cerr << "Error! Can't initialize spacecraft!" << std::endl;
-			std::exit(1);
+			auto& drone = scene.spawn<Spacecraft>(Transform{getRandomLocation(fleetExtent)});
+			drone.startAutopilot(fleetExtent, Random::get().getRandomFloat(0.5f, 2.f));
 		}
+	}
 
-		spacecraft = freshSpacecraft.get();
+	void LerpWithQuats::initActors()
+	{	
+		// Scripts hold references into the actors, and the scheduler pointers.
+		scripts.clear();
+		scheduler.clear();
+		scene.clear();
+		scene.reserve(2 + options.spacecraftCount);
+		scripts.reserve(1 + options.spacecraftCount);
 
-		auto ground = createGround();
+		spacecraft = &createSpacecraft(scene);
+		createGround(scene);
 
-		actors.push_back(std::move(freshSpacecraft));
-		actors.push_back(std::move(ground));
+		spawnStressFleet(scene, options.spacecraftCount);
 		
-		for(const auto& actor : actors)
+		for(auto* actor : scene.getActors())
 			actor->init();
+
+		// The player every frame, the fleet at its own rate, the ground only
+		// when something wakes it.
+		const auto playerGroup = scheduler.addGroup("player", 1);
+		const auto fleetGroup = scheduler.addGroup("fleet", std::max(1u, options.fleetTickInterval));
+		const auto staticGroup = scheduler.addGroup("static", 0);
+
+		for(auto* actor : scene.getActors())
+		{
+			if(actor == spacecraft)
+				scheduler.add(*actor, playerGroup);
+			else if(actor->isDormant())
+				scheduler.add(*actor, staticGroup);
+			else
+				scheduler.add(*actor, fleetGroup);
+		}
 	}
-	void LerpWithQuats::setup(void)
+	void LerpWithQuats::initScene()
 	{
 		glClearColor(1.0, 1.0, 1.0, 1.0);
 		glEnable(GL_DEPTH_TEST);
 
+		renderer.init();
+
 		initActors();
+		startSimulation();
+	}
+
+	void LerpWithQuats::setup(void)
+	{
+		initScene();
 
-		tp = std::chrono::system_clock::now();
-		animate(1);
+		pacer.setTargetFps(options.targetFps);
+		requestRedraw();
 	}
 
 	void LerpWithQuats::resize(int w, int h)
@@ -116,25 +538,32 @@
 		width = w;
 		height = h;
 
+		// Projection and view are folded into every matrix the renderer loads.
 		glMatrixMode(GL_PROJECTION);
 		glLoadIdentity();
-		glFrustum(-5.0, 5.0, -5.0, 5.0, 5.0, 250.0);
+		renderer.setCamera(camera);
 
 		glMatrixMode(GL_MODELVIEW);
 	}
 
+	void LerpWithQuats::reshape(int w, int h)
+	{
+		resize(w, h);
+		requestRedraw();
+	}
+
 	void LerpWithQuats::keyInput(unsigned char key, int x, int y)
 	{
 		switch (key)
 		{
 		case 27:
-			exit(0);
-			break;
+			glutLeaveMainLoop();
+			return;
 		default:
 			break;
 		}
 
-		spacecraft->keyInput(key, x, y);
+		postInput({InputEvent::Type::KeyDown, key, x, y});
 	}
 
 	void LerpWithQuats::keyInputUp(unsigned char key, int x, int y)
@@ -142,25 +571,23 @@
 		switch (key)
 		{
 		case 27:
-			exit(0);
-			break;
+			glutLeaveMainLoop();
+			return;
 		default:
 			break;
 		}
 
-		spacecraft->keyInputUp(key, x, y);
+		postInput({InputEvent::Type::KeyUp, key, x, y});
 	}
 
 	void LerpWithQuats::specialFunc(int key, int x, int y)
 	{	
-		spacecraft->specialDownFunc(key, x, y);
-		glutPostRedisplay();
+		postInput({InputEvent::Type::SpecialDown, key, x, y});
 	}
 
 	void LerpWithQuats::specialUpFunc(int key, int x, int y)
 	{
-		spacecraft->specialUpFunc(key, x, y);
-		glutPostRedisplay();
+		postInput({InputEvent::Type::SpecialUp, key, x, y});
 	}
 
 	void LerpWithQuats::printInteraction()
@@ -176,6 +603,47 @@
 
 	int LerpWithQuats::main(int argc, char** argv)
 	{
+		options = Options::parse(argc, argv);
+
+		if(options.seed >= 0)
+			Random::get().seed(static_cast<unsigned int>(options.seed));
+
+		if(!options.replayPath.empty())
+			return dumpReplay();
+
+		if(!options.recordPath.empty())
+			recorder = std::make_unique<ReplayRecorder>(options.recordPath, options.keyframeInterval);
+
+		if(!options.telemetryName.empty())
+		{
+			telemetry = std::make_unique<TelemetryWriter>(options.telemetryName);
+
+			if(!telemetry->isOpen())
+				return 1;
+		}
+
+		if(options.motionCacheMiB > 0)
+		{
+			motionCache = std::make_unique<MotionCache>(options.motionCacheMiB << 20);
+			scripts.setMotionCache(motionCache.get());
+		}
+
+		if(const auto r = runBenchmark())
+		{
+			recorder.reset();
+			return *r;
+		}
+
+		if(options.offscreenFrames > 0)
+		{
+			const auto r = runOffscreen();
+			recorder.reset();
+			return r;
+		}
+
+		width = options.width;
+		height = options.height;
+
 		printInteraction();
 		glutInit(&argc, argv);
 
@@ -187,11 +655,12 @@
 		glutInitWindowPosition(100, 100);
 		glutCreateWindow("LerpWithQuats");
 		glutDisplayFunc(drawScene);
-		glutReshapeFunc(resize);
+		glutReshapeFunc(reshape);
 		glutKeyboardFunc(keyInput);
 		glutKeyboardUpFunc(keyInputUp);
 		glutSpecialFunc(specialFunc);
 		glutSpecialUpFunc(specialUpFunc);
+		glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE, GLUT_ACTION_GLUTMAINLOOP_RETURNS);
 		glewExperimental = GL_TRUE;
 		glewInit();
 
@@ -199,14 +668,37 @@
 
 		glutMainLoop();
 
+		stopSimulation();
+		printFramePacing();
+		recorder.reset();
+
 		return 0;
 	}
 
+	Options LerpWithQuats::options{};
 	Spacecraft* LerpWithQuats::spacecraft{};
-	std::chrono::system_clock::time_point LerpWithQuats::tp{};
+	std::unique_ptr<ReplayRecorder> LerpWithQuats::recorder{};
+	std::unique_ptr<TelemetryWriter> LerpWithQuats::telemetry{};
+	std::unique_ptr<MotionCache> LerpWithQuats::motionCache{};
+	TripleBuffer<RenderSnapshot> LerpWithQuats::snapshots{};
+	TickScheduler LerpWithQuats::scheduler{};
+	ScriptScheduler LerpWithQuats::scripts{};
+	Renderer LerpWithQuats::renderer{};
+	Camera LerpWithQuats::camera{};
+	std::thread LerpWithQuats::simulationThread{};
+	std::atomic<bool> LerpWithQuats::simulationRunning{};
+	std::atomic<std::uint64_t> LerpWithQuats::framesConsumed{};
+	std::uint64_t LerpWithQuats::framesProduced{};
+	SpscQueue<InputEvent> LerpWithQuats::inputQueue{1024};
+	KeyState LerpWithQuats::heldKeys{};
+	KeyState LerpWithQuats::sentKeys{};
+	bool LerpWithQuats::inputDropped{};
+	std::chrono::steady_clock::time_point LerpWithQuats::tp{};
 	float LerpWithQuats::deltaTime{};
-	int LerpWithQuats::animationPeriod{};
+	FramePacer LerpWithQuats::pacer{};
+	int LerpWithQuats::pendingRedraws{};
+	bool LerpWithQuats::animating{};
 	int LerpWithQuats::width{800};
 	int LerpWithQuats::height{600};
 
-	std::vector<std::unique_ptr<Actor>> LerpWithQuats::actors{};
+	Scene LerpWithQuats::scene{};
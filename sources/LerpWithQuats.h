@@ -1,8 +1,25 @@
 #pragma once
+#include <atomic>
 #include <chrono>
+#include <optional>
+#include <thread>
+#include <GL/glew.h>
+#include <GL/freeglut.h>
 #include "Actor.h"
 #include "Utils.h"
 #include "Spacecraft.h"
+#include "ReplayLog.h"
+#include "Options.h"
+#include "InputEvent.h"
+#include "KeyState.h"
+#include "Renderer.h"
+#include "TripleBuffer.h"
+#include "SpscQueue.h"
+#include "TickScheduler.h"
+#include "FramePacer.h"
+#include "Scene.h"
+#include "MotionScript.h"
+#include "Telemetry.h"
 
 struct LerpWithQuats
 {
@@ -18,12 +35,12 @@ struct LerpWithQuats
 	{	
 		T* r{};
 
-		for (auto& actor : actors)
+		for (auto* actor : scene.getActors())
 		{
 			for (const auto& tag : actor->tags)
 			{
 				if (tag == T::tag)
-					r = static_cast<T*>(actor.get());
+					r = static_cast<T*>(actor);
 			}
 		}
 			
@@ -44,28 +61,95 @@ struct LerpWithQuats
 		return *r;
 	}
 
-	static std::vector<std::unique_ptr<Actor>> actors;
+	// Visible/culled counters of the last drawn frame.
+	static const RenderStats& getRenderStats()
+	{
+		return renderer.getStats();
+	}
+
+	// Per tick group actor counts and cost of the last simulation step.
+	static const std::vector<TickGroupStats>& getTickStats()
+	{
+		return scheduler.getStats();
+	}
+
+	// Motion scripts run on the simulation thread, resumed at the start of
+	// each simulation step before actors tick.
+	static ScriptScheduler& getScripts()
+	{
+		return scripts;
+	}
+
+	static Scene scene;
 	static void setMatrix(const std::array<float, 16>& newMatrix);
 
 	private:
 
+	// Simulation thread
 	static void tick();
+	static void simulationLoop();
+	static void drainInput();
+
+	// Render thread
 	static void drawScene();
+	static bool acquireSnapshot();
+	static void renderScene(const RenderSnapshot& snapshot);
+	static int runOffscreen();
+	// The --bench* mode the options select, in Benchmarks.cpp; empty when
+	// there is none.
+	static std::optional<int> runBenchmark();
+	static void startSimulation();
+	static void stopSimulation();
+	static void postInput(InputEvent event);
+	static bool pushInput(InputEvent event);
+	static void resyncInput();
+
 	static void animate(int value);
+	static void requestRedraw();
+	static void printFramePacing();
 	static void initActors();
+	static void initScene();
 	static void setup();
 	static void resize(int w, int h);
+	static void reshape(int w, int h);
 	static void keyInput(unsigned char key, int x, int y);
 	static void keyInputUp(unsigned char key, int x, int y);
 	static void specialFunc(int key, int x, int y);
 	static void specialUpFunc(int key, int x, int y);
 	static void printInteraction();
-	static void drawPlayerHUD();
+	static void drawPlayerHUD(const RenderSnapshot& snapshot);
+	static void recordFrame();
+	static int dumpReplay();
 
+	static Options options;
 	static Spacecraft* spacecraft;
-	static std::chrono::system_clock::time_point tp;
+	static std::unique_ptr<ReplayRecorder> recorder;
+	static std::unique_ptr<TelemetryWriter> telemetry;
+	static std::unique_ptr<MotionCache> motionCache;
+
+	static TripleBuffer<RenderSnapshot> snapshots;
+	static TickScheduler scheduler;
+	static ScriptScheduler scripts;
+	static Renderer renderer;
+	static Camera camera;
+	static std::thread simulationThread;
+	static std::atomic<bool> simulationRunning;
+	static std::atomic<std::uint64_t> framesConsumed;
+	static std::uint64_t framesProduced;
+
+	// GLUT callbacks produce, the simulation step consumes. While the ring
+	// is full, events are dropped; resyncInput() then sends a press or
+	// release for each key where the two differ.
+	static SpscQueue<InputEvent> inputQueue;
+	static KeyState heldKeys;	// as GLUT reported them last
+	static KeyState sentKeys;	// as the events pushed leave them
+	static bool inputDropped;
+
+	static std::chrono::steady_clock::time_point tp;
 	static float deltaTime;
-	static int animationPeriod;
+	static FramePacer pacer;
+	static int pendingRedraws;
+	static bool animating;
 	static int width;
 	static int height;
 
@@ -0,0 +1,243 @@
+#include "Matrix.h"
+#include "SimdMath.h"
+#include <cmath>
+
+Matrix identityMatrix() noexcept
+{
+    return {
+        1.f, 0.f, 0.f, 0.f,
+        0.f, 1.f, 0.f, 0.f,
+        0.f, 0.f, 1.f, 0.f,
+        0.f, 0.f, 0.f, 1.f
+    };
+}
+
+#ifdef LWQ_SIMD_SSE
+
+#define LWQ_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, (x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define LWQ_SWIZZLE(a, x, y, z, w) LWQ_SHUFFLE(a, a, x, y, z, w)
+
+// A column of a * b is a's columns weighted by the four entries of the
+// matching column of b: four broadcasts and multiply-adds.
+static inline __m128 multiplyColumn(const __m128 (&a)[4], __m128 c) noexcept
+{
+    __m128 r = _mm_mul_ps(a[0], LWQ_SWIZZLE(c, 0, 0, 0, 0));
+    r = _mm_add_ps(r, _mm_mul_ps(a[1], LWQ_SWIZZLE(c, 1, 1, 1, 1)));
+    r = _mm_add_ps(r, _mm_mul_ps(a[2], LWQ_SWIZZLE(c, 2, 2, 2, 2)));
+    r = _mm_add_ps(r, _mm_mul_ps(a[3], LWQ_SWIZZLE(c, 3, 3, 3, 3)));
+
+    return r;
+}
+
+// 2x2 blocks held as (m00, m01, m10, m11) in one register.
+static inline __m128 multiply2x2(__m128 a, __m128 b) noexcept
+{
+    return _mm_add_ps(_mm_mul_ps(a, LWQ_SWIZZLE(b, 0, 3, 0, 3)),
+                      _mm_mul_ps(LWQ_SWIZZLE(a, 1, 0, 3, 2), LWQ_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+// adj(a) * b
+static inline __m128 adjugateMultiply2x2(__m128 a, __m128 b) noexcept
+{
+    return _mm_sub_ps(_mm_mul_ps(LWQ_SWIZZLE(a, 3, 3, 0, 0), b),
+                      _mm_mul_ps(LWQ_SWIZZLE(a, 1, 1, 2, 2), LWQ_SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+// a * adj(b)
+static inline __m128 multiplyAdjugate2x2(__m128 a, __m128 b) noexcept
+{
+    return _mm_sub_ps(_mm_mul_ps(a, LWQ_SWIZZLE(b, 3, 0, 3, 0)),
+                      _mm_mul_ps(LWQ_SWIZZLE(a, 1, 0, 3, 2), LWQ_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+#endif
+
+Matrix multiplyMatrices(const Matrix& a, const Matrix& b) noexcept
+{
+    Matrix r;
+    multiplyMatrices(a, &b, &r, 1);
+    return r;
+}
+
+void multiplyMatrices(const Matrix& a, const Matrix* b, Matrix* out, std::size_t count) noexcept
+{
+#ifdef LWQ_SIMD_SSE
+    const __m128 columns[4]{
+        _mm_loadu_ps(a.data()), _mm_loadu_ps(a.data() + 4),
+        _mm_loadu_ps(a.data() + 8), _mm_loadu_ps(a.data() + 12)
+    };
+
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        // b[i] is read completely before out[i] is written, so they may alias.
+        const float* source = b[i].data();
+        const __m128 c0 = _mm_loadu_ps(source);
+        const __m128 c1 = _mm_loadu_ps(source + 4);
+        const __m128 c2 = _mm_loadu_ps(source + 8);
+        const __m128 c3 = _mm_loadu_ps(source + 12);
+
+        float* destination = out[i].data();
+        _mm_storeu_ps(destination, multiplyColumn(columns, c0));
+        _mm_storeu_ps(destination + 4, multiplyColumn(columns, c1));
+        _mm_storeu_ps(destination + 8, multiplyColumn(columns, c2));
+        _mm_storeu_ps(destination + 12, multiplyColumn(columns, c3));
+    }
+#else
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        const Matrix source = b[i];
+
+        for(int col = 0; col < 4; ++col)
+            for(int row = 0; row < 4; ++row)
+            {
+                float sum{};
+                for(int k = 0; k < 4; ++k)
+                    sum += a[k * 4 + row] * source[col * 4 + k];
+                out[i][col * 4 + row] = sum;
+            }
+    }
+#endif
+}
+
+bool invertMatrix(const Matrix& m, Matrix& out) noexcept
+{
+#ifdef LWQ_SIMD_SSE
+    // Block inverse over the four 2x2 sub-matrices. Written for row-major
+    // storage; fed column-major data it inverts the transpose, and the
+    // transposed inverse stored row-major is the inverse column-major.
+    const __m128 r0 = _mm_loadu_ps(m.data());
+    const __m128 r1 = _mm_loadu_ps(m.data() + 4);
+    const __m128 r2 = _mm_loadu_ps(m.data() + 8);
+    const __m128 r3 = _mm_loadu_ps(m.data() + 12);
+
+    const __m128 a = _mm_movelh_ps(r0, r1);
+    const __m128 b = _mm_movehl_ps(r1, r0);
+    const __m128 c = _mm_movelh_ps(r2, r3);
+    const __m128 d = _mm_movehl_ps(r3, r2);
+
+    // (|A|, |B|, |C|, |D|)
+    const __m128 determinants = _mm_sub_ps(
+        _mm_mul_ps(LWQ_SHUFFLE(r0, r2, 0, 2, 0, 2), LWQ_SHUFFLE(r1, r3, 1, 3, 1, 3)),
+        _mm_mul_ps(LWQ_SHUFFLE(r0, r2, 1, 3, 1, 3), LWQ_SHUFFLE(r1, r3, 0, 2, 0, 2)));
+
+    const __m128 detA = LWQ_SWIZZLE(determinants, 0, 0, 0, 0);
+    const __m128 detB = LWQ_SWIZZLE(determinants, 1, 1, 1, 1);
+    const __m128 detC = LWQ_SWIZZLE(determinants, 2, 2, 2, 2);
+    const __m128 detD = LWQ_SWIZZLE(determinants, 3, 3, 3, 3);
+
+    const __m128 dc = adjugateMultiply2x2(d, c);
+    const __m128 ab = adjugateMultiply2x2(a, b);
+
+    __m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), multiply2x2(b, dc));
+    __m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), multiply2x2(c, ab));
+    __m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), multiplyAdjugate2x2(d, ab));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), multiplyAdjugate2x2(a, dc));
+
+    // |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+    __m128 trace = _mm_mul_ps(ab, LWQ_SWIZZLE(dc, 0, 2, 1, 3));
+    trace = _mm_add_ps(trace, LWQ_SWIZZLE(trace, 2, 3, 0, 1));
+    trace = _mm_add_ps(trace, LWQ_SWIZZLE(trace, 1, 0, 3, 2));
+
+    const __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+
+    if(_mm_cvtss_f32(det) == 0.f)
+        return false;
+
+    const __m128 scale = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), det);
+
+    x = _mm_mul_ps(x, scale);
+    y = _mm_mul_ps(y, scale);
+    z = _mm_mul_ps(z, scale);
+    w = _mm_mul_ps(w, scale);
+
+    _mm_storeu_ps(out.data(), LWQ_SHUFFLE(x, y, 3, 1, 3, 1));
+    _mm_storeu_ps(out.data() + 4, LWQ_SHUFFLE(x, y, 2, 0, 2, 0));
+    _mm_storeu_ps(out.data() + 8, LWQ_SHUFFLE(z, w, 3, 1, 3, 1));
+    _mm_storeu_ps(out.data() + 12, LWQ_SHUFFLE(z, w, 2, 0, 2, 0));
+
+    return true;
+#else
+    // Cofactor expansion, as in the GLU reference implementation.
+    Matrix inv;
+
+    inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+    inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+    inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+    inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+    inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+    inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+    inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+    inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+    inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+    inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+    inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+    inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+    inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+    inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+    inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+    inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+    const float det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+
+    if(det == 0.f)
+        return false;
+
+    const float invDet = 1.f / det;
+    for(int i = 0; i < 16; ++i)
+        out[i] = inv[i] * invDet;
+
+    return true;
+#endif
+}
+
+Matrix composeMatrix(const Vector& translation, const Quaternion& q, const Vector& scale) noexcept
+{
+    const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z, ww = q.w * q.w;
+    const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    return {
+        (ww + xx - yy - zz) * scale.X, 2.f * (xy + wz) * scale.X, 2.f * (xz - wy) * scale.X, 0.f,
+        2.f * (xy - wz) * scale.Y, (ww - xx + yy - zz) * scale.Y, 2.f * (yz + wx) * scale.Y, 0.f,
+        2.f * (xz + wy) * scale.Z, 2.f * (yz - wx) * scale.Z, (ww - xx - yy + zz) * scale.Z, 0.f,
+        translation.X, translation.Y, translation.Z, 1.f
+    };
+}
+
+Matrix lookAtMatrix(const Vector& eye, const Vector& center, const Vector& up) noexcept
+{
+    const auto f = normalize(center - eye);
+    const auto s = normalize(crossProduct(f, up));
+    const auto u = crossProduct(s, f);
+
+    return {
+        s.X, u.X, -f.X, 0.f,
+        s.Y, u.Y, -f.Y, 0.f,
+        s.Z, u.Z, -f.Z, 0.f,
+        -dotProduct(s, eye), -dotProduct(u, eye), dotProduct(f, eye), 1.f
+    };
+}
+
+Matrix frustumMatrix(float left, float right, float bottom, float top, float zNear, float zFar) noexcept
+{
+    Matrix m{};
+
+    m[0] = 2.f * zNear / (right - left);
+    m[5] = 2.f * zNear / (top - bottom);
+    m[8] = (right + left) / (right - left);
+    m[9] = (top + bottom) / (top - bottom);
+    m[10] = -(zFar + zNear) / (zFar - zNear);
+    m[11] = -1.f;
+    m[14] = -2.f * zFar * zNear / (zFar - zNear);
+
+    return m;
+}
+
+Vector transformPoint(const Matrix& m, const Vector& p) noexcept
+{
+    return {
+        m[0] * p.X + m[4] * p.Y + m[8] * p.Z + m[12],
+        m[1] * p.X + m[5] * p.Y + m[9] * p.Z + m[13],
+        m[2] * p.X + m[6] * p.Y + m[10] * p.Z + m[14]
+    };
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include "Utils.h"
+
+// Column-major 4x4 matrix, laid out the way GL and the shaders read it:
+// element (row, col) is m[col * 4 + row], a point is transformed as m * p.
+using Matrix = std::array<float, 16>;
+
+// The multiply and inverse run on SSE unless the build is scalar, see
+// SimdMath.h.
+Matrix identityMatrix() noexcept;
+
+// a * b.
+Matrix multiplyMatrices(const Matrix& a, const Matrix& b) noexcept;
+
+// out[i] = a * b[i]; how model-view-projection matrices for a whole frame
+// are made from the shared view-projection. out may alias b.
+void multiplyMatrices(const Matrix& a, const Matrix* b, Matrix* out, std::size_t count) noexcept;
+
+// General inverse. False, leaving out untouched, when m is singular.
+bool invertMatrix(const Matrix& m, Matrix& out) noexcept;
+
+// translation * rotation * scale, for a unit quaternion.
+Matrix composeMatrix(const Vector& translation, const Quaternion& rotation,
+	const Vector& scale = {1.f, 1.f, 1.f}) noexcept;
+
+// The matrices gluLookAt and glFrustum build.
+Matrix lookAtMatrix(const Vector& eye, const Vector& center, const Vector& up) noexcept;
+Matrix frustumMatrix(float left, float right, float bottom, float top, float zNear, float zFar) noexcept;
+
+// m * (p, 1), without the perspective divide.
+Vector transformPoint(const Matrix& m, const Vector& p) noexcept;
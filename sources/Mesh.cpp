@@ -0,0 +1,323 @@
+#include "Mesh.h"
+#include "Utils.h"
+#include <algorithm>
+#include <limits>
+
+MeshData makeCone(float base, float height, int slices, int stacks)
+{
+    MeshData r;
+
+    slices = std::max(slices, 3);
+    stacks = std::max(stacks, 1);
+
+    // One ring per stack below the apex, then the apex and the base center.
+    for (int stack = 0; stack < stacks; ++stack)
+    {
+        const float f = float(stack) / stacks;
+        const float radius = base * (1.f - f);
+
+        for (int slice = 0; slice < slices; ++slice)
+        {
+            const float angle = 2.f * float(M_PI) * slice / slices;
+            r.positions.insert(r.positions.end(), {radius * std::cos(angle), radius * std::sin(angle), height * f});
+        }
+    }
+
+    const auto apex = static_cast<std::uint32_t>(stacks * slices);
+    const auto baseCenter = apex + 1;
+
+    r.positions.insert(r.positions.end(), {0.f, 0.f, height});
+    r.positions.insert(r.positions.end(), {0.f, 0.f, 0.f});
+
+    const auto at = [slices](int stack, int slice)
+    {
+        return static_cast<std::uint32_t>(stack * slices + slice % slices);
+    };
+
+    for (int stack = 0; stack + 1 < stacks; ++stack)
+        for (int slice = 0; slice < slices; ++slice)
+        {
+            r.indices.insert(r.indices.end(), {at(stack, slice), at(stack, slice + 1), at(stack + 1, slice + 1)});
+            r.indices.insert(r.indices.end(), {at(stack, slice), at(stack + 1, slice + 1), at(stack + 1, slice)});
+        }
+
+    for (int slice = 0; slice < slices; ++slice)
+    {
+        r.indices.insert(r.indices.end(), {at(stacks - 1, slice), at(stacks - 1, slice + 1), apex});
+        r.indices.insert(r.indices.end(), {baseCenter, at(0, slice + 1), at(0, slice)});
+    }
+
+    return r;
+}
+
+MeshData makeCube(float size)
+{
+    MeshData r;
+
+    const float h = size / 2.f;
+
+    for (int i = 0; i < 8; ++i)
+        r.positions.insert(r.positions.end(), {(i & 1) ? h : -h, (i & 2) ? h : -h, (i & 4) ? h : -h});
+
+    r.indices = {
+        0, 2, 3, 0, 3, 1,   // -z
+        4, 5, 7, 4, 7, 6,   // +z
+        0, 1, 5, 0, 5, 4,   // -y
+        2, 6, 7, 2, 7, 3,   // +y
+        0, 4, 6, 0, 6, 2,   // -x
+        1, 3, 7, 1, 7, 5    // +x
+    };
+
+    return r;
+}
+
+MeshData makeSphere(float radius, int slices, int stacks)
+{
+    MeshData r;
+
+    slices = std::max(slices, 3);
+    stacks = std::max(stacks, 2);
+
+    // Inner rings only; the poles are single vertices.
+    for (int stack = 1; stack < stacks; ++stack)
+    {
+        const float phi = float(M_PI) * stack / stacks;
+
+        for (int slice = 0; slice < slices; ++slice)
+        {
+            const float theta = 2.f * float(M_PI) * slice / slices;
+            r.positions.insert(r.positions.end(), {
+                radius * std::sin(phi) * std::cos(theta),
+                radius * std::sin(phi) * std::sin(theta),
+                radius * std::cos(phi)
+            });
+        }
+    }
+
+    const auto rings = stacks - 1;
+    const auto top = static_cast<std::uint32_t>(rings * slices);
+    const auto bottom = top + 1;
+
+    r.positions.insert(r.positions.end(), {0.f, 0.f, radius});
+    r.positions.insert(r.positions.end(), {0.f, 0.f, -radius});
+
+    const auto at = [slices](int ring, int slice)
+    {
+        return static_cast<std::uint32_t>(ring * slices + slice % slices);
+    };
+
+    for (int slice = 0; slice < slices; ++slice)
+    {
+        r.indices.insert(r.indices.end(), {top, at(0, slice), at(0, slice + 1)});
+        r.indices.insert(r.indices.end(), {bottom, at(rings - 1, slice + 1), at(rings - 1, slice)});
+    }
+
+    for (int ring = 0; ring + 1 < rings; ++ring)
+        for (int slice = 0; slice < slices; ++slice)
+        {
+            r.indices.insert(r.indices.end(), {at(ring, slice), at(ring + 1, slice), at(ring + 1, slice + 1)});
+            r.indices.insert(r.indices.end(), {at(ring, slice), at(ring + 1, slice + 1), at(ring, slice + 1)});
+        }
+
+    return r;
+}
+
+constexpr int vertexCacheSize{32};
+
+static float getVertexScore(int cachePosition, std::uint32_t remainingTriangles)
+{
+    if (remainingTriangles == 0) return -1.f;
+
+    float score{};
+
+    if (cachePosition >= 0)
+    {
+        // The three vertices of the last triangle get a fixed score so the
+        // next triangle does not simply reuse the same edge forever.
+        if (cachePosition < 3)
+            score = 0.75f;
+        else
+            score = std::pow(1.f - float(cachePosition - 3) / (vertexCacheSize - 3), 1.5f);
+    }
+
+    // Favor vertices with few triangles left so they get finished off.
+    return score + 2.f / std::sqrt(float(remainingTriangles));
+}
+
+void optimizeVertexCache(std::vector<std::uint32_t>& indices, std::size_t vertexCount)
+{
+    const auto triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return;
+
+    // Triangles adjacent to each vertex; the first remaining[v] entries of a
+    // vertex's range are the triangles not yet emitted.
+    std::vector<std::uint32_t> remaining(vertexCount);
+    for (const auto index : indices)
+        ++remaining[index];
+
+    std::vector<std::uint32_t> offsets(vertexCount + 1);
+    for (std::size_t v = 0; v < vertexCount; ++v)
+        offsets[v + 1] = offsets[v] + remaining[v];
+
+    std::vector<std::uint32_t> adjacency(indices.size());
+    {
+        std::vector<std::uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (std::size_t i = 0; i < indices.size(); ++i)
+            adjacency[cursor[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (std::size_t v = 0; v < vertexCount; ++v)
+        vertexScore[v] = getVertexScore(-1, remaining[v]);
+
+    std::vector<float> triangleScore(triangleCount);
+    for (std::size_t t = 0; t < triangleCount; ++t)
+        triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+    std::vector<bool> emitted(triangleCount);
+    std::vector<std::uint32_t> result;
+    result.reserve(indices.size());
+
+    std::vector<std::uint32_t> cache;
+    std::vector<std::uint32_t> nextCache;
+    cache.reserve(vertexCacheSize + 3);
+    nextCache.reserve(vertexCacheSize + 3);
+
+    std::int64_t best{-1};
+
+    for (std::size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+    {
+        if (best < 0)
+        {
+            // Nothing adjacent to the cache: restart from the best remaining
+            // triangle anywhere in the mesh.
+            float bestScore{-1.f};
+            for (std::size_t t = 0; t < triangleCount; ++t)
+            {
+                if (!emitted[t] && triangleScore[t] > bestScore)
+                {
+                    bestScore = triangleScore[t];
+                    best = static_cast<std::int64_t>(t);
+                }
+            }
+        }
+
+        const auto triangle = static_cast<std::size_t>(best);
+        emitted[triangle] = true;
+
+        nextCache.clear();
+
+        for (int k = 0; k < 3; ++k)
+        {
+            const auto v = indices[triangle * 3 + k];
+            result.push_back(v);
+            nextCache.push_back(v);
+
+            auto* begin = adjacency.data() + offsets[v];
+            auto* end = begin + remaining[v];
+            auto* it = std::find(begin, end, static_cast<std::uint32_t>(triangle));
+            std::swap(*it, *(end - 1));
+            --remaining[v];
+        }
+
+        for (const auto v : cache)
+        {
+            if (std::find(nextCache.begin(), nextCache.end(), v) == nextCache.end())
+                nextCache.push_back(v);
+        }
+
+        // Vertices pushed out of the cache lose their cache bonus.
+        for (std::size_t i = vertexCacheSize; i < nextCache.size(); ++i)
+        {
+            const auto v = nextCache[i];
+            cachePosition[v] = -1;
+            vertexScore[v] = getVertexScore(-1, remaining[v]);
+
+            for (auto j = offsets[v]; j < offsets[v] + remaining[v]; ++j)
+            {
+                const auto t = adjacency[j];
+                triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] +
+                                   vertexScore[indices[t * 3 + 2]];
+            }
+        }
+
+        if (nextCache.size() > std::size_t(vertexCacheSize))
+            nextCache.resize(vertexCacheSize);
+
+        for (std::size_t i = 0; i < nextCache.size(); ++i)
+        {
+            const auto v = nextCache[i];
+            cachePosition[v] = static_cast<int>(i);
+            vertexScore[v] = getVertexScore(cachePosition[v], remaining[v]);
+        }
+
+        std::swap(cache, nextCache);
+
+        best = -1;
+        float bestScore{-1.f};
+
+        for (const auto v : cache)
+        {
+            for (auto i = offsets[v]; i < offsets[v] + remaining[v]; ++i)
+            {
+                const auto t = adjacency[i];
+                const auto score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] +
+                                   vertexScore[indices[t * 3 + 2]];
+                triangleScore[t] = score;
+
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    best = t;
+                }
+            }
+        }
+    }
+
+    indices = std::move(result);
+}
+
+void optimizeVertexFetch(MeshData& mesh)
+{
+    constexpr auto unused = std::numeric_limits<std::uint32_t>::max();
+
+    std::vector<std::uint32_t> remap(mesh.getVertexCount(), unused);
+    std::vector<float> positions;
+    positions.reserve(mesh.positions.size());
+
+    std::uint32_t next{};
+
+    for (auto& index : mesh.indices)
+    {
+        if (remap[index] == unused)
+        {
+            remap[index] = next++;
+            positions.insert(positions.end(), mesh.positions.begin() + index * 3, mesh.positions.begin() + index * 3 + 3);
+        }
+
+        index = remap[index];
+    }
+
+    mesh.positions = std::move(positions);
+}
+
+float computeAcmr(const std::vector<std::uint32_t>& indices, std::size_t cacheSize)
+{
+    if (indices.size() < 3) return 0.f;
+
+    std::vector<std::uint32_t> fifo;
+    std::size_t misses{};
+
+    for (const auto index : indices)
+    {
+        if (std::find(fifo.begin(), fifo.end(), index) != fifo.end()) continue;
+
+        ++misses;
+        fifo.push_back(index);
+        if (fifo.size() > cacheSize)
+            fifo.erase(fifo.begin());
+    }
+
+    return float(misses) / float(indices.size() / 3);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Indexed triangle mesh in model space, positions only (the scene is unlit).
+struct MeshData
+{
+	std::vector<float> positions;
+	std::vector<std::uint32_t> indices;
+
+	std::size_t getVertexCount() const noexcept
+	{
+		return positions.size() / 3;
+	}
+};
+
+// Same shape as glutSolidCone: base disk at z = 0, apex at z = height.
+MeshData makeCone(float base, float height, int slices, int stacks);
+
+// Same shape as glutSolidCube: axis aligned, centered at the origin.
+MeshData makeCube(float size);
+
+// Same shape as glutSolidSphere: centered at the origin, poles on the z axis.
+MeshData makeSphere(float radius, int slices, int stacks);
+
+// Reorders triangles for post-transform vertex cache reuse (Forsyth's
+// linear-speed algorithm, 32-entry LRU model). The triangle set is unchanged.
+void optimizeVertexCache(std::vector<std::uint32_t>& indices, std::size_t vertexCount);
+
+// Renumbers vertices in order of first use so the index stream walks the
+// vertex buffer mostly forward.
+void optimizeVertexFetch(MeshData& mesh);
+
+// Average cache miss ratio: transformed vertices per triangle for a FIFO cache
+// of the given size. 0.5 is the ideal for a regular grid, 3 the worst case.
+float computeAcmr(const std::vector<std::uint32_t>& indices, std::size_t cacheSize = 16);
@@ -0,0 +1,48 @@
+#include "MeshCache.h"
+
+const MeshData& MeshCache::get(const MeshKey& key)
+{
+    const auto it = meshes.find(key);
+
+    if (it != meshes.end())
+    {
+        ++stats.hits;
+        return it->second;
+    }
+
+    ++stats.misses;
+    return meshes.emplace(key, generate(key)).first->second;
+}
+
+const MeshCacheStats& MeshCache::getStats() const noexcept
+{
+    return stats;
+}
+
+std::size_t MeshCache::size() const noexcept
+{
+    return meshes.size();
+}
+
+MeshData MeshCache::generate(const MeshKey& key)
+{
+    MeshData r;
+
+    switch (key.shape)
+    {
+    case MeshType::Cone:
+        r = makeCone(5.f, 10.f, key.slices, key.stacks);
+        break;
+    case MeshType::Cube:
+        r = makeCube(1.f);
+        break;
+    case MeshType::Sphere:
+        r = makeSphere(1.f, key.slices, key.stacks);
+        break;
+    }
+
+    optimizeVertexCache(r.indices, r.getVertexCount());
+    optimizeVertexFetch(r);
+
+    return r;
+}
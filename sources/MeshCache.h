@@ -0,0 +1,48 @@
+#pragma once
+
+#include <map>
+#include <tuple>
+#include "Mesh.h"
+#include "RenderSnapshot.h"
+
+// Shape and tessellation of a procedural mesh. Cubes ignore the counts.
+struct MeshKey
+{
+	MeshType shape;
+	int slices;
+	int stacks;
+
+	bool operator<(const MeshKey& rhs) const noexcept
+	{
+		return std::tie(shape, slices, stacks) < std::tie(rhs.shape, rhs.slices, rhs.stacks);
+	}
+
+	bool operator==(const MeshKey& rhs) const noexcept
+	{
+		return !(*this < rhs) && !(rhs < *this);
+	}
+};
+
+struct MeshCacheStats
+{
+	std::size_t hits{};
+	std::size_t misses{};
+};
+
+// CPU-side cache of generated meshes. Each key is generated, cache-optimized
+// and stored once; references stay valid for the cache's lifetime. Needs no
+// GL context.
+struct MeshCache
+{
+	const MeshData& get(const MeshKey& key);
+
+	const MeshCacheStats& getStats() const noexcept;
+	std::size_t size() const noexcept;
+
+	static MeshData generate(const MeshKey& key);
+
+private:
+
+	std::map<MeshKey, MeshData> meshes;
+	MeshCacheStats stats;
+};
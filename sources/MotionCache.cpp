@@ -0,0 +1,175 @@
+#include "MotionCache.h"
+#include <cmath>
+#include <cstring>
+
+BakedMotion::BakedMotion(const MotionSpec& spec, float pSamplesPerTick)
+:
+    samplesPerTick{pSamplesPerTick},
+    poses{}
+{
+    const auto count = std::size_t(getEntryCount(spec, samplesPerTick));
+    poses.reserve(count);
+
+    for(std::size_t k = 0; k < count; ++k)
+    {
+        const auto pose = sampleMotion(spec, float(k) / samplesPerTick);
+        const auto& q = pose.rotation;
+        const auto& t = pose.translation;
+
+        poses.push_back({{q.w, q.x, q.y, q.z}, {t.X, t.Y, t.Z}});
+    }
+}
+
+double BakedMotion::getEntryCount(const MotionSpec& spec, float samplesPerTick) noexcept
+{
+    if(!(spec.speed > 0.f) || !(samplesPerTick > 0.f))
+        return HUGE_VAL;
+
+    // Entry k at tick k / samplesPerTick; the last one is at or past the end,
+    // where sampleMotion() has clamped to the end pose.
+    return double(std::ceil(getMotionDuration(spec) * samplesPerTick)) + 1.0;
+}
+
+Pose BakedMotion::sample(float ticks) const noexcept
+{
+    const float x = clamp(0.f, float(poses.size() - 1), ticks * samplesPerTick);
+    const auto i = std::size_t(x);
+    const float f = x - float(i);
+
+    const auto& a = poses[i];
+    Pose r;
+
+    if(f == 0.f)
+    {
+        r.rotation = {a.rotation[0], a.rotation[1], a.rotation[2], a.rotation[3]};
+        r.translation = {a.translation[0], a.translation[1], a.translation[2]};
+        return r;
+    }
+
+    // Neighbouring entries are close, so nlerp is as good as slerp here.
+    const auto& b = poses[i + 1];
+    const float u = 1.f - f;
+
+    r.rotation = normalizeQuat({
+        a.rotation[0] * u + b.rotation[0] * f, a.rotation[1] * u + b.rotation[1] * f,
+        a.rotation[2] * u + b.rotation[2] * f, a.rotation[3] * u + b.rotation[3] * f});
+    r.translation = {
+        a.translation[0] * u + b.translation[0] * f,
+        a.translation[1] * u + b.translation[1] * f,
+        a.translation[2] * u + b.translation[2] * f};
+
+    return r;
+}
+
+std::size_t BakedMotion::getBytes() const noexcept
+{
+    return sizeof(*this) + poses.capacity() * sizeof(PackedPose);
+}
+
+MotionCache::MotionCache(std::size_t budgetBytes, float pSamplesPerTick)
+:
+    samplesPerTick{pSamplesPerTick},
+    lru{},
+    index{},
+    stats{}
+{
+    stats.budget = budgetBytes;
+}
+
+std::shared_ptr<const BakedMotion> MotionCache::get(const MotionSpec& spec)
+{
+    if(spec.path)
+        return nullptr;
+
+    ++stats.lookups;
+
+    const auto key = makeKey(spec);
+    const auto found = index.find(key);
+
+    if(found != index.end())
+    {
+        ++stats.hits;
+        lru.splice(lru.begin(), lru, found->second);
+        return found->second->baked;
+    }
+
+    // Sized from the duration first: a motion too long for the budget, or
+    // one that never ends, isn't baked at all.
+    const double count = BakedMotion::getEntryCount(spec, samplesPerTick);
+    if(!(double(sizeof(BakedMotion)) + count * double(sizeof(BakedMotion::PackedPose)) <= double(stats.budget)))
+        return nullptr;
+
+    auto baked = std::make_shared<const BakedMotion>(spec, samplesPerTick);
+    const auto bytes = baked->getBytes();
+
+    lru.push_front({key, baked});
+    index.emplace(key, lru.begin());
+    stats.bytes += bytes;
+    stats.entries = lru.size();
+
+    while(stats.bytes > stats.budget)
+        evict();
+
+    return baked;
+}
+
+void MotionCache::clear()
+{
+    index.clear();
+    lru.clear();
+    stats.bytes = 0;
+    stats.entries = 0;
+}
+
+const MotionCacheStats& MotionCache::getStats() const noexcept
+{
+    return stats;
+}
+
+MotionCache::Key MotionCache::makeKey(const MotionSpec& spec) noexcept
+{
+    const float values[16]{
+        spec.rotStart.w, spec.rotStart.x, spec.rotStart.y, spec.rotStart.z,
+        spec.rotEnd.w, spec.rotEnd.x, spec.rotEnd.y, spec.rotEnd.z,
+        spec.start.X, spec.start.Y, spec.start.Z,
+        spec.end.X, spec.end.Y, spec.end.Z,
+        spec.speed, 0.f
+    };
+
+    Key key;
+    std::memcpy(key.words.data(), values, sizeof(values));
+    key.mode = std::uint32_t(spec.mode);
+
+    return key;
+}
+
+std::size_t MotionCache::KeyHash::operator()(const Key& key) const noexcept
+{
+    // FNV-1a over the words.
+    std::uint64_t h = 14695981039346656037ull;
+
+    const auto mix = [&h](std::uint64_t v)
+    {
+        h ^= v;
+        h *= 1099511628211ull;
+    };
+
+    for(const auto word : key.words)
+        mix(word);
+
+    mix(key.mode);
+
+    return std::size_t(h);
+}
+
+void MotionCache::evict()
+{
+    const auto& oldest = lru.back();
+
+    stats.bytes -= oldest.baked->getBytes();
+    ++stats.evictions;
+
+    index.erase(oldest.key);
+    lru.pop_back();
+    stats.entries = lru.size();
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "MotionSample.h"
+
+// A motion sampled at a fixed rate into a table of packed poses. Sampling
+// between entries nlerps the rotation and lerps the translation; at entry
+// times (every integer tick at the default rate) it returns exactly what
+// sampleMotion() does.
+struct BakedMotion
+{
+	struct PackedPose
+	{
+		float rotation[4];
+		float translation[3];
+	};
+
+	// The motion must end, see getEntryCount().
+	BakedMotion(const MotionSpec& spec, float samplesPerTick);
+
+	// Table entries for `spec`; infinite for a motion that never ends (speed
+	// zero, negative or NaN) or a rate that isn't positive, and possibly too
+	// large for std::size_t.
+	static double getEntryCount(const MotionSpec& spec, float samplesPerTick) noexcept;
+
+	Pose sample(float ticks) const noexcept;
+
+	std::size_t getBytes() const noexcept;
+
+private:
+
+	float samplesPerTick;
+	std::vector<PackedPose> poses;
+};
+
+struct MotionCacheStats
+{
+	std::uint64_t lookups{};
+	std::uint64_t hits{};
+	std::uint64_t evictions{};
+	std::size_t entries{};
+	std::size_t bytes{};
+	std::size_t budget{};
+
+	double getHitRate() const noexcept
+	{
+		return lookups ? double(hits) / double(lookups) : 0.0;
+	}
+};
+
+// Bakes motions on first use and hands the same table to every later motion
+// with bit-identical poses, speed and mode. Least recently used tables are
+// dropped once the total exceeds the budget; motions already holding one keep
+// it. Motions along a path are not baked, the path is a table already. Not
+// thread-safe: use it from the simulation thread.
+struct MotionCache
+{
+	explicit MotionCache(std::size_t budgetBytes, float samplesPerTick = 1.f);
+
+	// The baked table, or null for a path motion or one that alone exceeds
+	// the budget, checked before anything is baked.
+	std::shared_ptr<const BakedMotion> get(const MotionSpec& spec);
+
+	void clear();
+
+	const MotionCacheStats& getStats() const noexcept;
+
+private:
+
+	struct Key
+	{
+		std::array<std::uint32_t, 16> words;
+		std::uint32_t mode;
+
+		bool operator==(const Key& other) const noexcept = default;
+	};
+
+	struct KeyHash
+	{
+		std::size_t operator()(const Key& key) const noexcept;
+	};
+
+	struct Entry
+	{
+		Key key;
+		std::shared_ptr<const BakedMotion> baked;
+	};
+
+	static Key makeKey(const MotionSpec& spec) noexcept;
+
+	void evict();
+
+	float samplesPerTick;
+	std::list<Entry> lru;	// most recently used first
+	std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+	MotionCacheStats stats;
+};
@@ -0,0 +1,59 @@
+#include "MotionSample.h"
+#include "DualQuaternion.h"
+#include "ThreadPool.h"
+
+// Items per chunk handed to a pool thread; large enough to amortize the
+// shared counter, small enough to balance uneven path lookups.
+constexpr std::size_t sampleGrain = 4096;
+
+float getMotionDuration(const MotionSpec& spec) noexcept
+{
+    return 100.f / spec.speed;
+}
+
+float getMotionProgress(const MotionSpec& spec, float ticks) noexcept
+{
+    return clamp(0.f, 1.f, ticks * 0.01f * spec.speed);
+}
+
+Pose sampleMotion(const MotionSpec& spec, float ticks)
+{
+    const float t = getMotionProgress(spec, ticks);
+
+    Pose r;
+
+    if(!spec.path && spec.mode != MotionMode::Separate)
+    {
+        const auto from = DualQuaternion::fromRotationTranslation(spec.rotStart, spec.start);
+        const auto to = DualQuaternion::fromRotationTranslation(spec.rotEnd, spec.end);
+        const auto dq = spec.mode == MotionMode::ScrewLinear ? sclerp(from, to, t) : dlb(from, to, t);
+
+        r.rotation = dq.getRotation();
+        r.translation = dq.getTranslation();
+    }
+    else
+    {
+        r.rotation = slerp(spec.rotStart, spec.rotEnd, t);
+        r.translation = spec.path ? spec.path->evaluate(t * spec.path->getLength()) : lerp(spec.start, spec.end, t);
+    }
+
+    return r;
+}
+
+void sampleMotions(const MotionSpec* specs, const float* ticks, Pose* out, std::size_t count,
+                   ThreadPool* pool)
+{
+    const auto body = [specs, ticks, out](std::size_t begin, std::size_t end)
+    {
+        for(std::size_t i = begin; i < end; ++i)
+            out[i] = sampleMotion(specs[i], ticks[i]);
+    };
+
+    if(pool == nullptr)
+    {
+        body(0, count);
+        return;
+    }
+
+    pool->parallelFor(count, sampleGrain, body);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include "Path.h"
+#include "Pose.h"
+
+struct ThreadPool;
+
+// How a motion moves between its two poses. Separate lerps the translation
+// and slerps the rotation; the other two treat the pose as one rigid
+// transform and follow a screw motion. Paths always use Separate.
+enum class MotionMode
+{
+	Separate,
+	DualQuaternionBlend,
+	ScrewLinear
+};
+
+// Everything that determines a motion. Progress advances by 0.01 * speed per
+// simulation tick, so a motion lasts 100 / speed ticks.
+struct MotionSpec
+{
+	Quaternion rotStart{1.f};
+	Quaternion rotEnd{1.f};
+	Vector start{};
+	Vector end{};
+	std::shared_ptr<const Path> path{};
+	float speed{1.f};
+	MotionMode mode{MotionMode::Separate};
+};
+
+float getMotionDuration(const MotionSpec& spec) noexcept;
+
+// Progress in [0, 1] after the given number of ticks.
+float getMotionProgress(const MotionSpec& spec, float ticks) noexcept;
+
+// Pose of the motion after the given number of ticks. Pure: no actor, no
+// state, any time in any order, from any thread.
+Pose sampleMotion(const MotionSpec& spec, float ticks);
+
+// out[i] = sampleMotion(specs[i], ticks[i]). Spread over the pool when one is
+// given, on the calling thread otherwise.
+void sampleMotions(const MotionSpec* specs, const float* ticks, Pose* out, std::size_t count,
+                   ThreadPool* pool = nullptr);
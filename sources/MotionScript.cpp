@@ -0,0 +1,256 @@
+#include "MotionScript.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Coroutine frames rounded up to 64-byte size classes, each with its own free
+// list carved out of 64-block chunks. Frames over 1 KiB fall back to the heap.
+struct ScriptFramePool
+{
+    static constexpr std::size_t granularity = 64;
+    static constexpr std::size_t classCount = 16;
+    static constexpr std::size_t blocksPerChunk = 64;
+
+    void* allocate(std::size_t size)
+    {
+        const std::size_t sizeClass = (size + granularity - 1) / granularity;
+
+        if(sizeClass > classCount)
+        {
+            ++stats.heapFallbacks;
+            return ::operator new(size);
+        }
+
+        auto& head = freeLists[sizeClass - 1];
+
+        if(head == nullptr)
+            addChunk(sizeClass);
+
+        auto* block = head;
+        head = block->next;
+        ++stats.liveFrames;
+
+        return block;
+    }
+
+    void deallocate(void* p, std::size_t size) noexcept
+    {
+        const std::size_t sizeClass = (size + granularity - 1) / granularity;
+
+        if(sizeClass > classCount)
+        {
+            ::operator delete(p);
+            return;
+        }
+
+        auto& head = freeLists[sizeClass - 1];
+        head = new(p) FreeBlock{head};
+        --stats.liveFrames;
+    }
+
+    ScriptFramePoolStats stats;
+
+private:
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    void addChunk(std::size_t sizeClass)
+    {
+        const std::size_t blockSize = sizeClass * granularity;
+
+        chunks.push_back(std::make_unique<std::byte[]>(blockSize * blocksPerChunk));
+        ++stats.chunks;
+        stats.reservedBytes += blockSize * blocksPerChunk;
+
+        auto* base = chunks.back().get();
+        auto& head = freeLists[sizeClass - 1];
+
+        for(std::size_t i = blocksPerChunk; i-- > 0;)
+            head = new(base + i * blockSize) FreeBlock{head};
+    }
+
+    std::array<FreeBlock*, classCount> freeLists{};
+    std::vector<std::unique_ptr<std::byte[]>> chunks;
+};
+
+// Never destroyed: static schedulers hand their frames back during exit,
+// possibly after a function-local pool would already be gone.
+static ScriptFramePool& getScriptFramePool()
+{
+    static auto* pool = new ScriptFramePool;
+    return *pool;
+}
+
+ScriptFramePoolStats getScriptFramePoolStats() noexcept
+{
+    return getScriptFramePool().stats;
+}
+
+void MotionScript::promise_type::unhandled_exception() noexcept
+{
+    std::cerr << "Error! Motion script threw an exception" << std::endl;
+    std::abort();
+}
+
+void* MotionScript::promise_type::operator new(std::size_t size)
+{
+    return getScriptFramePool().allocate(size);
+}
+
+void MotionScript::promise_type::operator delete(void* p, std::size_t size) noexcept
+{
+    getScriptFramePool().deallocate(p, size);
+}
+
+MotionScript::MotionScript(Handle pHandle) noexcept
+:
+    handle{pHandle}
+{
+
+}
+
+MotionScript::MotionScript(MotionScript&& other) noexcept
+:
+    handle{std::exchange(other.handle, nullptr)}
+{
+
+}
+
+MotionScript& MotionScript::operator=(MotionScript&& other) noexcept
+{
+    if(this != &other)
+    {
+        if(handle)
+            handle.destroy();
+
+        handle = std::exchange(other.handle, nullptr);
+    }
+
+    return *this;
+}
+
+MotionScript::~MotionScript()
+{
+    if(handle)
+        handle.destroy();
+}
+
+ScriptScheduler::~ScriptScheduler()
+{
+    clear();
+}
+
+void ScriptScheduler::start(MotionScript script)
+{
+    resume(std::exchange(script.handle, nullptr));
+}
+
+void ScriptScheduler::tick()
+{
+    ++now;
+    resumed = 0;
+
+    // Resumed scripts may land in this same slot again, a full turn later.
+    auto& slot = wheel[now % wheelSize];
+    due.swap(slot);
+
+    for(const auto& wake : due)
+    {
+        if(wake.tick > now)
+        {
+            slot.push_back(wake);
+            continue;
+        }
+
+        --scripts;
+        resume(wake.handle);
+        ++resumed;
+    }
+
+    due.clear();
+}
+
+void ScriptScheduler::clear()
+{
+    for(auto& slot : wheel)
+    {
+        for(const auto& wake : slot)
+            wake.handle.destroy();
+
+        slot.clear();
+    }
+
+    scripts = 0;
+}
+
+void ScriptScheduler::reserve(std::size_t count)
+{
+    // Spread evenly; slots grow past this on their own when wakes bunch up.
+    for(auto& slot : wheel)
+        slot.reserve(count / wheelSize * 2);
+
+    due.reserve(count / wheelSize * 2);
+}
+
+ScriptScheduler::Delay ScriptScheduler::wait(std::uint64_t ticks) noexcept
+{
+    return {*this, now + std::max<std::uint64_t>(ticks, 1)};
+}
+
+ScriptScheduler::Delay ScriptScheduler::play(MotionTrack& track, MotionSpec spec)
+{
+    auto ticks = std::max<std::uint64_t>(std::uint64_t(std::ceil(getMotionDuration(spec))), 1);
+
+    // The float duration can round a hair short of full progress.
+    if(getMotionProgress(spec, float(ticks)) < 1.f)
+        ++ticks;
+
+    track.baked = cache ? cache->get(spec) : nullptr;
+    track.spec = std::move(spec);
+    track.startTick = now;
+    track.endTick = now + ticks;
+
+    return {*this, track.endTick};
+}
+
+void ScriptScheduler::setMotionCache(MotionCache* newCache) noexcept
+{
+    cache = newCache;
+}
+
+std::uint64_t ScriptScheduler::getNow() const noexcept
+{
+    return now;
+}
+
+std::size_t ScriptScheduler::getScriptCount() const noexcept
+{
+    return scripts;
+}
+
+std::size_t ScriptScheduler::getResumedCount() const noexcept
+{
+    return resumed;
+}
+
+void ScriptScheduler::schedule(std::coroutine_handle<> handle, std::uint64_t wakeTick)
+{
+    wheel[wakeTick % wheelSize].push_back({wakeTick, handle});
+    ++scripts;
+}
+
+void ScriptScheduler::resume(std::coroutine_handle<> handle)
+{
+    handle.resume();
+
+    if(handle.done())
+        handle.destroy();
+}
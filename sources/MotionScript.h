@@ -0,0 +1,168 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MotionCache.h"
+#include "MotionSample.h"
+
+// The motion an agent is currently playing. Stateless between ticks: the pose
+// at any tick is sampled from the spec, or from its baked table when the
+// scheduler has a motion cache, and after the motion ends it holds the end
+// pose, so nothing has to run per agent per frame to keep it current.
+struct MotionTrack
+{
+	MotionSpec spec{};
+	std::shared_ptr<const BakedMotion> baked{};
+	std::uint64_t startTick{};
+	std::uint64_t endTick{};
+
+	bool isMoving(std::uint64_t now) const noexcept
+	{
+		return now < endTick;
+	}
+
+	Pose sample(std::uint64_t now) const
+	{
+		const float ticks = float(now - startTick);
+		return baked ? baked->sample(ticks) : sampleMotion(spec, ticks);
+	}
+};
+
+struct ScriptScheduler;
+
+// Return type of a motion script coroutine, e.g.
+//
+//     MotionScript patrol(ScriptScheduler& s, MotionTrack& track, MotionSpec there, MotionSpec back)
+//     {
+//         for(;;)
+//         {
+//             co_await s.play(track, there);
+//             co_await s.wait(120);
+//             co_await s.play(track, back);
+//         }
+//     }
+//
+// A script does nothing until handed to ScriptScheduler::start(). Its frame
+// comes from a pool of fixed-size blocks, not the global heap. Scripts must
+// only suspend on the scheduler's awaitables, and are created, run and
+// destroyed on one thread (the simulation thread).
+struct MotionScript
+{
+	struct promise_type
+	{
+		MotionScript get_return_object() noexcept
+		{
+			return MotionScript{std::coroutine_handle<promise_type>::from_promise(*this)};
+		}
+
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void return_void() noexcept {}
+		void unhandled_exception() noexcept;
+
+		static void* operator new(std::size_t size);
+		static void operator delete(void* p, std::size_t size) noexcept;
+	};
+
+	using Handle = std::coroutine_handle<promise_type>;
+
+	MotionScript(MotionScript&& other) noexcept;
+	MotionScript& operator=(MotionScript&& other) noexcept;
+	~MotionScript();
+
+	MotionScript(const MotionScript&) = delete;
+	MotionScript& operator=(const MotionScript&) = delete;
+
+private:
+
+	friend struct ScriptScheduler;
+
+	explicit MotionScript(Handle pHandle) noexcept;
+
+	Handle handle;
+};
+
+struct ScriptFramePoolStats
+{
+	std::size_t liveFrames{};
+	std::size_t chunks{};
+	std::size_t reservedBytes{};
+	std::uint64_t heapFallbacks{};
+};
+
+ScriptFramePoolStats getScriptFramePoolStats() noexcept;
+
+// Runs motion scripts in simulation ticks. A suspended script sits in a
+// timing wheel slot for its wake tick and is resumed only once the
+// interpolation or timer it awaits has completed, so a tick only touches the
+// scripts due on it, however many are mid motion. Scripts due on the same
+// tick resume in the order they suspended, which keeps replays deterministic.
+struct ScriptScheduler
+{
+	struct Delay
+	{
+		ScriptScheduler& scheduler;
+		std::uint64_t wakeTick;
+
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<> h) { scheduler.schedule(h, wakeTick); }
+		void await_resume() const noexcept {}
+	};
+
+	ScriptScheduler() = default;
+	~ScriptScheduler();
+
+	ScriptScheduler(const ScriptScheduler&) = delete;
+	ScriptScheduler& operator=(const ScriptScheduler&) = delete;
+
+	// Runs the script up to its first co_await.
+	void start(MotionScript script);
+
+	// Advances one tick and resumes every script due on it.
+	void tick();
+
+	// Destroys all scripts, suspended where they are.
+	void clear();
+
+	void reserve(std::size_t count);
+
+	// Motions started by play() from now on look their table up here; null
+	// turns baking off again. The cache must outlive the tracks.
+	void setMotionCache(MotionCache* newCache) noexcept;
+
+	// Suspends for the given number of ticks, at least one.
+	Delay wait(std::uint64_t ticks) noexcept;
+
+	// Starts the motion on the track now and suspends until it has ended.
+	Delay play(MotionTrack& track, MotionSpec spec);
+
+	std::uint64_t getNow() const noexcept;
+	std::size_t getScriptCount() const noexcept;
+
+	// Scripts resumed by the last tick().
+	std::size_t getResumedCount() const noexcept;
+
+private:
+
+	// Slot i holds the scripts waking on ticks congruent to i. Waits longer
+	// than the wheel stay in their slot for another turn.
+	static constexpr std::size_t wheelSize = 1024;
+
+	struct Wake
+	{
+		std::uint64_t tick;
+		std::coroutine_handle<> handle;
+	};
+
+	void schedule(std::coroutine_handle<> handle, std::uint64_t wakeTick);
+	void resume(std::coroutine_handle<> handle);
+
+	std::vector<std::vector<Wake>> wheel{wheelSize};
+	std::vector<Wake> due;
+	MotionCache* cache{};
+	std::uint64_t now{};
+	std::size_t scripts{};
+	std::size_t resumed{};
+};
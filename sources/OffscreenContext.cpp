@@ -0,0 +1,152 @@
+#include "OffscreenContext.h"
+#include <algorithm>
+#include <fstream>
+
+#ifdef LWQ_HAS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+OffscreenContext::~OffscreenContext()
+{
+#ifdef LWQ_HAS_EGL
+    if (display == nullptr) return;
+
+    if (context != nullptr)
+    {
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(display, context);
+    }
+
+    eglTerminate(display);
+#endif
+}
+
+bool OffscreenContext::create(int newWidth, int newHeight)
+{
+    width = newWidth;
+    height = newHeight;
+
+#ifdef LWQ_HAS_EGL
+    const auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+    if (getPlatformDisplay == nullptr)
+    {
+        std::cerr << "EGL_EXT_platform_base is not available" << std::endl;
+        return false;
+    }
+
+    display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+
+    EGLint major;
+    EGLint minor;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+    {
+        std::cerr << "Can't initialize a surfaceless EGL display" << std::endl;
+        display = nullptr;
+        return false;
+    }
+
+    eglBindAPI(EGL_OPENGL_API);
+
+    const EGLint configAttributes[]{
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+
+    EGLConfig config{};
+    EGLint configCount{};
+    eglChooseConfig(display, configAttributes, &config, 1, &configCount);
+
+    // Same version and profile the GLUT window asks for.
+    const EGLint contextAttributes[]{
+        EGL_CONTEXT_MAJOR_VERSION, 4,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT,
+        EGL_NONE
+    };
+
+    context = eglCreateContext(display, configCount > 0 ? config : EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttributes);
+
+    if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+    {
+        std::cerr << "Can't create an offscreen GL 4.3 context, EGL error 0x" << std::hex << eglGetError() << std::dec << std::endl;
+        context = nullptr;
+        return false;
+    }
+
+    // The framebuffer calls below go through GLEW's function pointers.
+    glewExperimental = GL_TRUE;
+    const auto glewStatus = glewInit();
+
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // A GLX build of GLEW loads the core entry points, then fails on the
+    // missing X display, which an EGL context never needs.
+    if (glewStatus != GLEW_OK && glewStatus != GLEW_ERROR_NO_GLX_DISPLAY)
+#else
+    if (glewStatus != GLEW_OK)
+#endif
+    {
+        std::cerr << "glewInit failed: " << glewGetErrorString(glewStatus) << std::endl;
+        return false;
+    }
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cerr << "Offscreen framebuffer is incomplete" << std::endl;
+        return false;
+    }
+
+    return true;
+#else
+    std::cerr << "Built without EGL, offscreen rendering is not available" << std::endl;
+    return false;
+#endif
+}
+
+void OffscreenContext::readPixels(std::vector<std::uint8_t>& rgb) const
+{
+    const auto rowSize = static_cast<std::size_t>(width) * 3;
+
+    std::vector<std::uint8_t> raw(rowSize * height);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, raw.data());
+
+    // GL returns the bottom row first.
+    rgb.resize(raw.size());
+    for (int row = 0; row < height; ++row)
+        std::copy_n(raw.data() + (height - 1 - row) * rowSize, rowSize, rgb.data() + row * rowSize);
+}
+
+bool OffscreenContext::writePpm(const std::string& path) const
+{
+    std::vector<std::uint8_t> rgb;
+    readPixels(rgb);
+
+    std::ofstream out{path, std::ios::binary};
+    if (!out)
+    {
+        std::cerr << "Can't write " << path << std::endl;
+        return false;
+    }
+
+    out << "P6\n" << width << ' ' << height << "\n255\n";
+    out.write(reinterpret_cast<const char*>(rgb.data()), rgb.size());
+
+    return bool(out);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+#include "Utils.h"
+
+// GL context without a window: a surfaceless EGL context (Mesa llvmpipe on
+// GPU-less machines) rendering into a framebuffer object.
+struct OffscreenContext
+{
+	OffscreenContext() = default;
+	~OffscreenContext();
+
+	OffscreenContext(const OffscreenContext&) = delete;
+	OffscreenContext& operator=(const OffscreenContext&) = delete;
+
+	// Creates the context, makes it current, initializes GLEW for it and
+	// binds a width x height color and depth framebuffer.
+	bool create(int newWidth, int newHeight);
+
+	// Tightly packed RGB rows, top row first.
+	void readPixels(std::vector<std::uint8_t>& rgb) const;
+	bool writePpm(const std::string& path) const;
+
+	int getWidth() const noexcept
+	{
+		return width;
+	}
+
+	int getHeight() const noexcept
+	{
+		return height;
+	}
+
+private:
+
+	void* display{};
+	void* context{};
+
+	GLuint framebuffer{};
+	GLuint colorBuffer{};
+	GLuint depthBuffer{};
+
+	int width{};
+	int height{};
+};
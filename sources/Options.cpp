@@ -0,0 +1,148 @@
+#include "Options.h"
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+static std::string requireValue(int& i, int argc, char** argv)
+{
+    if (i + 1 >= argc)
+    {
+        std::cerr << "Option " << argv[i] << " requires a value" << std::endl;
+        std::exit(1);
+    }
+
+    return argv[++i];
+}
+
+Options Options::parse(int argc, char** argv)
+{
+    Options r;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg{argv[i]};
+
+        try
+        {
+            if (arg == "--record")
+            {
+                r.recordPath = requireValue(i, argc, argv);
+            }
+            else if (arg == "--keyframe-interval")
+            {
+                r.keyframeInterval = static_cast<std::uint32_t>(std::stoul(requireValue(i, argc, argv)));
+            }
+            else if (arg == "--telemetry")
+            {
+                r.telemetryName = requireValue(i, argc, argv);
+            }
+            else if (arg == "--offscreen")
+            {
+                r.offscreenFrames = std::stoull(requireValue(i, argc, argv));
+            }
+            else if (arg == "--dump-frames")
+            {
+                r.dumpDirectory = requireValue(i, argc, argv);
+            }
+            else if (arg == "--size")
+            {
+                const auto size = requireValue(i, argc, argv);
+                const auto x = size.find('x');
+
+                if (x == std::string::npos)
+                {
+                    std::cerr << "--size expects WIDTHxHEIGHT, got " << size << std::endl;
+                    std::exit(1);
+                }
+
+                r.width = std::stoi(size.substr(0, x));
+                r.height = std::stoi(size.substr(x + 1));
+            }
+            else if (arg == "--fps")
+            {
+                r.targetFps = std::stod(requireValue(i, argc, argv));
+            }
+            else if (arg == "--continuous")
+            {
+                r.continuousRedraw = true;
+            }
+            else if (arg == "--spacecraft")
+            {
+                r.spacecraftCount = std::stoull(requireValue(i, argc, argv));
+            }
+            else if (arg == "--fleet-tick-interval")
+            {
+                r.fleetTickInterval = static_cast<unsigned>(std::stoul(requireValue(i, argc, argv)));
+            }
+            else if (arg == "--bench")
+            {
+                r.benchFrames = std::stoull(requireValue(i, argc, argv));
+            }
+            else if (arg == "--bench-blend")
+            {
+                r.blendBenchActors = std::stoull(requireValue(i, argc, argv));
+            }
+            else if (arg == "--bench-interpolation")
+            {
+                r.interpolationBenchPoses = std::stoull(requireValue(i, argc, argv));
+            }
+            else if (arg == "--bench-sample")
+            {
+                r.sampleBenchCount = std::stoull(requireValue(i, argc, argv));
+            }
+            else if (arg == "--bench-extrapolation")
+            {
+                r.extrapolationBenchActors = std::stoull(requireValue(i, argc, argv));
+            }
+            else if (arg == "--bench-scene")
+            {
+                r.sceneBenchActors = std::stoull(requireValue(i, argc, argv));
+            }
+            else if (arg == "--bench-scripts")
+            {
+                r.scriptBenchCount = std::stoull(requireValue(i, argc, argv));
+            }
+            else if (arg == "--bench-motion-cache")
+            {
+                r.motionCacheBenchActors = std::stoull(requireValue(i, argc, argv));
+            }
+            else if (arg == "--bench-matrices")
+            {
+                r.matrixBenchCount = std::stoull(requireValue(i, argc, argv));
+            }
+            else if (arg == "--bench-vector-ops")
+            {
+                r.vectorBenchCount = std::stoull(requireValue(i, argc, argv));
+            }
+            else if (arg == "--motion-cache")
+            {
+                r.motionCacheMiB = std::stoull(requireValue(i, argc, argv));
+            }
+            else if (arg == "--seed")
+            {
+                r.seed = std::stoll(requireValue(i, argc, argv));
+            }
+            else if (arg == "--replay-dump")
+            {
+                r.replayPath = requireValue(i, argc, argv);
+
+                if (i + 1 < argc && argv[i + 1][0] != '-')
+                    r.replayFrame = std::stoll(argv[++i]);
+            }
+            else if (arg.rfind("--", 0) == 0)
+            {
+                // GLUT's own flags (-display, -geometry, ...) take one dash.
+                std::cerr << "Unknown option " << arg << std::endl;
+                std::exit(1);
+            }
+        }
+        catch (const std::logic_error&)
+        {
+            // std::stoul and friends: not a number, or out of range
+            std::cerr << "Option " << arg << " expects a number" << std::endl;
+            std::exit(1);
+        }
+    }
+
+    return r;
+}
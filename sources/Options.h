@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+struct Options
+{
+	// Parses the application's own options. Anything it does not recognize is
+	// left for glutInit.
+	static Options parse(int argc, char** argv);
+
+	std::string recordPath;
+	std::uint32_t keyframeInterval{60};
+
+	std::string telemetryName;
+
+	std::string replayPath;
+	std::int64_t replayFrame{-1};
+
+	std::uint64_t offscreenFrames{};
+	std::string dumpDirectory;
+	int width{800};
+	int height{600};
+
+	double targetFps{60.0};
+	bool continuousRedraw{};
+
+	std::size_t spacecraftCount{};
+	unsigned fleetTickInterval{1};
+	std::uint64_t benchFrames{};
+	std::int64_t seed{-1};
+
+	std::size_t blendBenchActors{};
+	std::size_t interpolationBenchPoses{};
+	std::size_t sampleBenchCount{};
+	std::size_t extrapolationBenchActors{};
+	std::size_t sceneBenchActors{};
+	std::size_t scriptBenchCount{};
+	std::size_t motionCacheBenchActors{};
+	std::size_t matrixBenchCount{};
+	std::size_t vectorBenchCount{};
+
+	std::size_t motionCacheMiB{};
+};
@@ -0,0 +1,111 @@
+#include "Path.h"
+#include <algorithm>
+
+// Samples taken per table entry while measuring the curve.
+constexpr std::size_t measureOversampling = 8;
+
+static Vector catmullRom(const Vector& p0, const Vector& p1, const Vector& p2, const Vector& p3, float t)
+{
+    const float t2 = t * t;
+    const float t3 = t2 * t;
+
+    return (p1 * 2.f
+        + (p2 - p0) * t
+        + (p0 * 2.f - p1 * 5.f + p2 * 4.f - p3) * t2
+        + (p1 * 3.f - p0 - p2 * 3.f + p3) * t3) * 0.5f;
+}
+
+Path::Path(std::vector<Vector> pPoints, std::size_t resolution)
+:
+    points{std::move(pPoints)},
+    parameterByDistance{},
+    length{},
+    step{}
+{
+    if(points.empty())
+        points.push_back({});
+
+    resolution = std::max<std::size_t>(resolution, 2);
+
+    const float segments = float(points.size() - 1);
+    if(segments == 0.f)
+    {
+        parameterByDistance.assign(resolution, 0.f);
+        return;
+    }
+
+    // Cumulative chord length over a dense uniform sampling of the parameter.
+    const std::size_t samples = resolution * measureOversampling;
+    std::vector<float> distances(samples + 1);
+
+    Vector previous = evaluateSpline(0.f);
+    for(std::size_t i = 1; i <= samples; ++i)
+    {
+        const Vector current = evaluateSpline(segments * float(i) / float(samples));
+        distances[i] = distances[i - 1] + (current - previous).length();
+        previous = current;
+    }
+
+    length = distances.back();
+    step = length / float(resolution - 1);
+
+    // Invert it: spline parameter at every multiple of step.
+    parameterByDistance.resize(resolution);
+    std::size_t j = 0;
+    for(std::size_t i = 0; i < resolution; ++i)
+    {
+        const float target = std::min(step * float(i), length);
+        while(j + 1 < samples && distances[j + 1] < target)
+            ++j;
+
+        const float span = distances[j + 1] - distances[j];
+        const float f = span > 0.f ? (target - distances[j]) / span : 0.f;
+        parameterByDistance[i] = segments * (float(j) + clamp(0.f, 1.f, f)) / float(samples);
+    }
+}
+
+float Path::getLength() const noexcept
+{
+    return length;
+}
+
+std::size_t Path::getResolution() const noexcept
+{
+    return parameterByDistance.size();
+}
+
+Vector Path::evaluate(float distance) const noexcept
+{
+    return evaluateSpline(getSplineParameter(distance));
+}
+
+void Path::evaluate(const float* distances, Vector* positions, std::size_t count) const noexcept
+{
+    for(std::size_t i = 0; i < count; ++i)
+        positions[i] = evaluateSpline(getSplineParameter(distances[i]));
+}
+
+float Path::getSplineParameter(float distance) const noexcept
+{
+    if(step == 0.f)
+        return 0.f;
+
+    const float x = clamp(0.f, float(parameterByDistance.size() - 1), distance / step);
+    const auto i = std::min(static_cast<std::size_t>(x), parameterByDistance.size() - 2);
+
+    return lerp(parameterByDistance[i], parameterByDistance[i + 1], x - float(i));
+}
+
+Vector Path::evaluateSpline(float u) const noexcept
+{
+    const std::size_t last = points.size() - 1;
+    const auto segment = std::min(static_cast<std::size_t>(u), last == 0 ? 0 : last - 1);
+    const float t = u - float(segment);
+
+    const Vector& p1 = points[segment];
+    const Vector& p2 = points[std::min(segment + 1, last)];
+    const Vector& p0 = segment > 0 ? points[segment - 1] : p1;
+    const Vector& p3 = segment + 2 <= last ? points[segment + 2] : p2;
+
+    return catmullRom(p0, p1, p2, p3, t);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "Utils.h"
+
+// Catmull-Rom curve through a list of points, parameterized by arc length.
+//
+// The spline parameter does not advance at constant speed, so the constructor
+// measures the curve once and stores the spline parameter at `resolution`
+// equally spaced distances. evaluate() then turns a distance into a position
+// with one table lookup and one spline evaluation, no integration. A larger
+// resolution trades memory for accuracy on tightly bent curves.
+struct Path
+{
+	explicit Path(std::vector<Vector> points, std::size_t resolution = 256);
+
+	float getLength() const noexcept;
+	std::size_t getResolution() const noexcept;
+
+	// Position at the given distance from the first point, clamped to the path.
+	Vector evaluate(float distance) const noexcept;
+
+	// Same as above for many agents sharing the path.
+	void evaluate(const float* distances, Vector* positions, std::size_t count) const noexcept;
+
+private:
+
+	Vector evaluateSpline(float u) const noexcept;
+	float getSplineParameter(float distance) const noexcept;
+
+	std::vector<Vector> points;
+	std::vector<float> parameterByDistance;
+	float length;
+	float step;
+};
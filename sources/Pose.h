@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+#include "Matrix.h"
+#include "Utils.h"
+
+// One actor's placement in 32 bytes, aligned so it never straddles a cache
+// line: unit quaternion, translation and a uniform scale. Actors keep their
+// orientation here instead of in separate Euler angle, quaternion and matrix
+// members; matrices are built from it when drawing.
+struct alignas(32) Pose
+{
+	Quaternion rotation{1.f};
+	Vector translation{};
+	float scale{1.f};
+};
+
+static_assert(sizeof(Pose) == 32, "Pose is meant to fill half a cache line");
+
+// Conversions for the constructors that still take a Transform. The scale of
+// a Pose is uniform, so only the X component of the Transform's scale is kept;
+// actors with a non-uniform size store it themselves.
+inline Pose toPose(const Transform& transform, const Quaternion& rotation = Quaternion{1.f})
+{
+	return {rotation, transform.translation, transform.scale.X == 0.f ? 1.f : transform.scale.X};
+}
+
+inline Transform toTransform(const Pose& pose)
+{
+	return {pose.translation, {pose.scale, pose.scale, pose.scale}};
+}
+
+// Column-major translation * rotation * scale, built straight from the pose.
+inline Matrix makeModelMatrix(const Pose& pose)
+{
+	return composeMatrix(pose.translation, pose.rotation, {pose.scale, pose.scale, pose.scale});
+}
+
+// Rotates v by a unit quaternion without going through a matrix.
+inline Vector rotateVector(const Quaternion& q, const Vector& v)
+{
+	const Vector u{q.x, q.y, q.z};
+	const Vector t = crossProduct(u, v) * 2.f;
+
+	return v + t * q.w + crossProduct(u, t);
+}
+
+// Structure-of-arrays storage for many poses, for loops that only touch one
+// or two components at a time.
+struct PoseArray
+{
+	std::size_t size() const noexcept
+	{
+		return scale.size();
+	}
+
+	void resize(std::size_t n)
+	{
+		rw.resize(n, 1.f);
+		rx.resize(n);
+		ry.resize(n);
+		rz.resize(n);
+		tx.resize(n);
+		ty.resize(n);
+		tz.resize(n);
+		scale.resize(n, 1.f);
+	}
+
+	void push_back(const Pose& pose)
+	{
+		resize(size() + 1);
+		set(size() - 1, pose);
+	}
+
+	Pose get(std::size_t i) const noexcept
+	{
+		return {{rw[i], rx[i], ry[i], rz[i]}, {tx[i], ty[i], tz[i]}, scale[i]};
+	}
+
+	void set(std::size_t i, const Pose& pose) noexcept
+	{
+		rw[i] = pose.rotation.w;
+		rx[i] = pose.rotation.x;
+		ry[i] = pose.rotation.y;
+		rz[i] = pose.rotation.z;
+		tx[i] = pose.translation.X;
+		ty[i] = pose.translation.Y;
+		tz[i] = pose.translation.Z;
+		scale[i] = pose.scale;
+	}
+
+	std::vector<float> rw, rx, ry, rz;
+	std::vector<float> tx, ty, tz;
+	std::vector<float> scale;
+};
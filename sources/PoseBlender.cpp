@@ -0,0 +1,215 @@
+#include "PoseBlender.h"
+#include <cmath>
+
+void PoseBlender::Channels::resize(std::size_t n, float wValue)
+{
+    w.resize(n, wValue);
+    x.resize(n);
+    y.resize(n);
+    z.resize(n);
+    tx.resize(n);
+    ty.resize(n);
+    tz.resize(n);
+}
+
+PoseBlender::PoseBlender(std::size_t pActorCount)
+:
+    actorCount{},
+    layers{},
+    out{},
+    totalWeight{}
+{
+    resize(pActorCount);
+}
+
+std::size_t PoseBlender::addLayer(LayerMode mode)
+{
+    layers.push_back({mode, {}, {}});
+    layers.back().pose.resize(actorCount, 1.f);
+    layers.back().weight.resize(actorCount);
+
+    return layers.size() - 1;
+}
+
+void PoseBlender::resize(std::size_t newActorCount)
+{
+    actorCount = newActorCount;
+
+    for(auto& layer : layers)
+    {
+        layer.pose.resize(actorCount, 1.f);
+        layer.weight.resize(actorCount);
+    }
+
+    out.resize(actorCount, 1.f);
+    totalWeight.resize(actorCount);
+}
+
+std::size_t PoseBlender::getActorCount() const noexcept
+{
+    return actorCount;
+}
+
+std::size_t PoseBlender::getLayerCount() const noexcept
+{
+    return layers.size();
+}
+
+void PoseBlender::setSource(std::size_t layer, std::size_t actor, const Quaternion& rotation,
+                            const Vector& translation, float weight)
+{
+    auto& p = layers[layer].pose;
+
+    p.w[actor] = rotation.w;
+    p.x[actor] = rotation.x;
+    p.y[actor] = rotation.y;
+    p.z[actor] = rotation.z;
+    p.tx[actor] = translation.X;
+    p.ty[actor] = translation.Y;
+    p.tz[actor] = translation.Z;
+    layers[layer].weight[actor] = weight;
+}
+
+void PoseBlender::setWeight(std::size_t layer, std::size_t actor, float weight)
+{
+    layers[layer].weight[actor] = weight;
+}
+
+void PoseBlender::blend()
+{
+    bool first = true;
+    for(const auto& layer : layers)
+    {
+        if(layer.mode == LayerMode::Blend)
+        {
+            accumulate(layer, first);
+            first = false;
+        }
+    }
+
+    // No blend layer at all: start the additive layers from the identity.
+    if(first)
+    {
+        out = {};
+        out.resize(actorCount, 1.f);
+        totalWeight.assign(actorCount, 0.f);
+    }
+
+    const std::size_t n = actorCount;
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        const float lengthSquared = out.w[i] * out.w[i] + out.x[i] * out.x[i]
+                                  + out.y[i] * out.y[i] + out.z[i] * out.z[i];
+
+        // Zero total weight leaves nothing to normalize; fall back to identity.
+        const bool degenerate = lengthSquared <= 1e-12f;
+        const float inverseLength = degenerate ? 0.f : 1.f / std::sqrt(lengthSquared);
+        const float inverseWeight = totalWeight[i] > 0.f ? 1.f / totalWeight[i] : 0.f;
+
+        out.w[i] = degenerate ? 1.f : out.w[i] * inverseLength;
+        out.x[i] *= inverseLength;
+        out.y[i] *= inverseLength;
+        out.z[i] *= inverseLength;
+        out.tx[i] *= inverseWeight;
+        out.ty[i] *= inverseWeight;
+        out.tz[i] *= inverseWeight;
+    }
+
+    for(const auto& layer : layers)
+    {
+        if(layer.mode == LayerMode::Additive)
+            applyAdditive(layer);
+    }
+}
+
+void PoseBlender::accumulate(const Layer& layer, bool first)
+{
+    const auto& p = layer.pose;
+    const std::size_t n = actorCount;
+
+    if(first)
+    {
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            const float weight = layer.weight[i];
+
+            out.w[i] = p.w[i] * weight;
+            out.x[i] = p.x[i] * weight;
+            out.y[i] = p.y[i] * weight;
+            out.z[i] = p.z[i] * weight;
+            out.tx[i] = p.tx[i] * weight;
+            out.ty[i] = p.ty[i] * weight;
+            out.tz[i] = p.tz[i] * weight;
+            totalWeight[i] = weight;
+        }
+
+        return;
+    }
+
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        // Flip into the accumulator's hemisphere so q and -q do not cancel.
+        const float dot = out.w[i] * p.w[i] + out.x[i] * p.x[i] + out.y[i] * p.y[i] + out.z[i] * p.z[i];
+        const float weight = layer.weight[i];
+        const float signedWeight = dot < 0.f ? -weight : weight;
+
+        out.w[i] += p.w[i] * signedWeight;
+        out.x[i] += p.x[i] * signedWeight;
+        out.y[i] += p.y[i] * signedWeight;
+        out.z[i] += p.z[i] * signedWeight;
+        out.tx[i] += p.tx[i] * weight;
+        out.ty[i] += p.ty[i] * weight;
+        out.tz[i] += p.tz[i] * weight;
+        totalWeight[i] += weight;
+    }
+}
+
+void PoseBlender::applyAdditive(const Layer& layer)
+{
+    const auto& p = layer.pose;
+    const std::size_t n = actorCount;
+
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        // Scale the delta towards identity: nlerp(identity, delta, weight),
+        // taking the short way round.
+        const float weight = layer.weight[i];
+        const float sign = p.w[i] < 0.f ? -1.f : 1.f;
+
+        float dw = 1.f - weight + p.w[i] * sign * weight;
+        float dx = p.x[i] * sign * weight;
+        float dy = p.y[i] * sign * weight;
+        float dz = p.z[i] * sign * weight;
+
+        const float inverseLength = 1.f / std::sqrt(dw * dw + dx * dx + dy * dy + dz * dz);
+        dw *= inverseLength;
+        dx *= inverseLength;
+        dy *= inverseLength;
+        dz *= inverseLength;
+
+        // Local space, like the spacecraft's key rotations: out = out * delta.
+        const float w = out.w[i];
+        const float x = out.x[i];
+        const float y = out.y[i];
+        const float z = out.z[i];
+
+        out.w[i] = w * dw - x * dx - y * dy - z * dz;
+        out.x[i] = w * dx + x * dw + y * dz - z * dy;
+        out.y[i] = w * dy + y * dw + z * dx - x * dz;
+        out.z[i] = w * dz + z * dw + x * dy - y * dx;
+
+        out.tx[i] += p.tx[i] * weight;
+        out.ty[i] += p.ty[i] * weight;
+        out.tz[i] += p.tz[i] * weight;
+    }
+}
+
+Quaternion PoseBlender::getOrientation(std::size_t actor) const noexcept
+{
+    return {out.w[actor], out.x[actor], out.y[actor], out.z[actor]};
+}
+
+Vector PoseBlender::getTranslation(std::size_t actor) const noexcept
+{
+    return {out.tx[actor], out.ty[actor], out.tz[actor]};
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "Utils.h"
+
+// Combines any number of weighted pose layers per actor in one pass.
+//
+// Blend layers are mixed by weighted quaternion accumulation: every source is
+// flipped into the hemisphere of the first blend layer, scaled by its weight,
+// summed and normalized once. Translations are averaged by the same weights.
+// Additive layers are applied afterwards, in the order they were added, as a
+// rotation delta (scaled towards identity by the weight) and a translation
+// offset. There are no acos/sin calls, so the cost is linear in layers.
+//
+// All data is stored per layer in structure-of-arrays form so each layer is a
+// straight loop over the actors.
+struct PoseBlender
+{
+	enum class LayerMode
+	{
+		Blend,
+		Additive
+	};
+
+	explicit PoseBlender(std::size_t actorCount = 0);
+
+	// Returns the layer index. Sources default to identity with zero weight.
+	std::size_t addLayer(LayerMode mode);
+
+	void resize(std::size_t actorCount);
+	std::size_t getActorCount() const noexcept;
+	std::size_t getLayerCount() const noexcept;
+
+	void setSource(std::size_t layer, std::size_t actor, const Quaternion& rotation,
+	               const Vector& translation, float weight);
+	void setWeight(std::size_t layer, std::size_t actor, float weight);
+
+	void blend();
+
+	Quaternion getOrientation(std::size_t actor) const noexcept;
+	Vector getTranslation(std::size_t actor) const noexcept;
+
+private:
+
+	struct Channels
+	{
+		void resize(std::size_t n, float wValue);
+
+		std::vector<float> w, x, y, z;
+		std::vector<float> tx, ty, tz;
+	};
+
+	struct Layer
+	{
+		LayerMode mode;
+		Channels pose;
+		std::vector<float> weight;
+	};
+
+	void accumulate(const Layer& layer, bool first);
+	void applyAdditive(const Layer& layer);
+
+	std::size_t actorCount;
+	std::vector<Layer> layers;
+
+	Channels out;
+	std::vector<float> totalWeight;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include "RenderSnapshot.h"
+
+constexpr std::size_t meshTypeCount{3};
+constexpr std::size_t lodTierCount{3};
+
+// Per-instance data as the instanced shader reads it. The matrix is the whole
+// model-view-projection; the shader only multiplies it with the vertex.
+struct InstanceData
+{
+	std::array<float, 16> mvp;
+	std::array<float, 4> color;
+};
+
+// Visible instances of one frame, bucketed by mesh and level of detail so
+// each bucket becomes one instanced draw call.
+struct RenderQueue
+{
+	static std::size_t getBucket(MeshType mesh, std::size_t lod) noexcept
+	{
+		return static_cast<std::size_t>(mesh) * lodTierCount + lod;
+	}
+
+	void clear()
+	{
+		for (auto& bucket : buckets)
+			bucket.clear();
+	}
+
+	void add(MeshType mesh, std::size_t lod, const std::array<float, 16>& mvp, const Color& color)
+	{
+		buckets[getBucket(mesh, lod)].push_back({
+			mvp,
+			{color.R, color.G, color.B, 1.f}
+		});
+	}
+
+	std::size_t getInstanceCount() const noexcept
+	{
+		std::size_t r{};
+		for (const auto& bucket : buckets)
+			r += bucket.size();
+		return r;
+	}
+
+	std::array<std::vector<InstanceData>, meshTypeCount * lodTierCount> buckets;
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Utils.h"
+
+enum class MeshType
+{
+	Cone,
+	Cube,
+	Sphere
+};
+
+struct RenderItem
+{
+	MeshType mesh;
+	Color color;
+	std::array<float, 16> model;
+
+	// World-space bounding sphere, used for culling and level of detail.
+	Vector boundsCenter;
+	float boundsRadius;
+};
+
+// Bounding sphere of a mesh in its own model space.
+inline void getMeshBounds(MeshType mesh, Vector& center, float& radius)
+{
+	switch (mesh)
+	{
+	case MeshType::Cone:
+		// glutSolidCone(5, 10): base radius 5 at z = 0, apex at z = 10
+		center = {0.f, 0.f, 5.f};
+		radius = std::sqrt(50.f);
+		break;
+	case MeshType::Cube:
+		center = {};
+		radius = std::sqrt(3.f) / 2.f;
+		break;
+	case MeshType::Sphere:
+		center = {};
+		radius = 1.f;
+		break;
+	}
+}
+
+inline RenderItem makeRenderItem(MeshType mesh, const Color& color, const std::array<float, 16>& model)
+{
+	Vector localCenter;
+	float localRadius;
+	getMeshBounds(mesh, localCenter, localRadius);
+
+	const auto& m = model;
+
+	const Vector center{
+		m[0] * localCenter.X + m[4] * localCenter.Y + m[8] * localCenter.Z + m[12],
+		m[1] * localCenter.X + m[5] * localCenter.Y + m[9] * localCenter.Z + m[13],
+		m[2] * localCenter.X + m[6] * localCenter.Y + m[10] * localCenter.Z + m[14]
+	};
+
+	float maxScale{};
+	for (int col = 0; col < 3; ++col)
+		maxScale = std::max(maxScale, Vector{m[col * 4], m[col * 4 + 1], m[col * 4 + 2]}.length());
+
+	return {mesh, color, model, center, localRadius * maxScale};
+}
+
+// Everything the render thread needs to draw one simulation frame. Built by
+// the simulation thread and never modified once published.
+struct RenderSnapshot
+{
+	std::uint64_t frame{};
+
+	// Some actor ticked while producing this frame; when false the scene is
+	// the same as in the previous one.
+	bool active{};
+	EulerAngles hudAngles;
+	std::vector<RenderItem> items;
+};
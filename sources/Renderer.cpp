@@ -0,0 +1,156 @@
+#include "Renderer.h"
+#include <limits>
+
+constexpr std::array<LodTier, lodTierCount> coneLods{{
+    {15.f, 20, 20},
+    {40.f, 12, 6},
+    {std::numeric_limits<float>::max(), 6, 2}
+}};
+
+constexpr std::array<LodTier, lodTierCount> sphereLods{{
+    {15.f, 16, 16},
+    {40.f, 10, 8},
+    {std::numeric_limits<float>::max(), 6, 4}
+}};
+
+MeshKey Renderer::getMeshKey(MeshType mesh, std::size_t lod)
+{
+    switch (mesh)
+    {
+    case MeshType::Cone:
+        return {mesh, coneLods[lod].slices, coneLods[lod].stacks};
+    case MeshType::Sphere:
+        return {mesh, sphereLods[lod].slices, sphereLods[lod].stacks};
+    case MeshType::Cube:
+        break;
+    }
+
+    // Six quads already; every tier draws the same cube.
+    return {MeshType::Cube, 0, 0};
+}
+
+void Renderer::init()
+{
+    InstancedRenderer::MeshKeySet keys;
+
+    for (std::size_t mesh = 0; mesh < meshTypeCount; ++mesh)
+        for (std::size_t lod = 0; lod < lodTierCount; ++lod)
+        {
+            const auto type = static_cast<MeshType>(mesh);
+            keys[RenderQueue::getBucket(type, lod)] = getMeshKey(type, lod);
+        }
+
+    instanced.init(gpuMeshes, keys);
+}
+
+void Renderer::setCamera(const Camera& newCamera)
+{
+    camera = newCamera;
+    viewProjection = camera.getViewProjection();
+    frustum = Frustum::fromMatrix(viewProjection);
+}
+
+void Renderer::draw(const RenderSnapshot& snapshot)
+{
+    stats = {};
+
+    cull(snapshot);
+    queue.clear();
+
+    // Every visible model matrix goes through the view-projection in one
+    // batch, so both paths get finished matrices and GL composes nothing.
+    mvps.clear();
+
+    for (std::size_t i = 0; i < snapshot.items.size(); ++i)
+    {
+        if (visible[i])
+            mvps.push_back(snapshot.items[i].model);
+        else
+            ++stats.culled;
+    }
+
+    multiplyMatrices(viewProjection, mvps.data(), mvps.data(), mvps.size());
+
+    std::size_t next{};
+
+    for (std::size_t i = 0; i < snapshot.items.size(); ++i)
+    {
+        if (!visible[i])
+            continue;
+
+        const auto& item = snapshot.items[i];
+        const auto& mvp = mvps[next++];
+        const auto lod = selectLod(item);
+
+        ++stats.visible;
+        ++stats.perLod[lod];
+
+        if (instanced.isReady())
+        {
+            queue.add(item.mesh, lod, mvp, item.color);
+            continue;
+        }
+
+        glColor3f(item.color.R, item.color.G, item.color.B);
+        glLoadMatrixf(mvp.data());
+        drawMesh(item.mesh, lod);
+
+        ++stats.drawCalls;
+    }
+
+    if (instanced.isReady())
+        stats.drawCalls = instanced.draw(queue);
+}
+
+const RenderStats& Renderer::getStats() const noexcept
+{
+    return stats;
+}
+
+const MeshCacheStats& Renderer::getMeshCacheStats() const noexcept
+{
+    return meshCache.getStats();
+}
+
+void Renderer::cull(const RenderSnapshot& snapshot)
+{
+    const auto count = snapshot.items.size();
+
+    boundsX.resize(count);
+    boundsY.resize(count);
+    boundsZ.resize(count);
+    boundsRadius.resize(count);
+    visible.resize(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto& item = snapshot.items[i];
+
+        boundsX[i] = item.boundsCenter.X;
+        boundsY[i] = item.boundsCenter.Y;
+        boundsZ[i] = item.boundsCenter.Z;
+        boundsRadius[i] = item.boundsRadius;
+    }
+
+    frustum.cullSpheres(boundsX.data(), boundsY.data(), boundsZ.data(), boundsRadius.data(),
+        count, visible.data());
+}
+
+std::size_t Renderer::selectLod(const RenderItem& item) const
+{
+    if (item.boundsRadius <= 0.f) return 0;
+
+    const float distance = (item.boundsCenter - camera.eye).length() / item.boundsRadius;
+
+    std::size_t lod{};
+    // Every shape switches tiers at the same distances.
+    while (lod + 1 < lodTierCount && distance > coneLods[lod].maxDistance)
+        ++lod;
+
+    return lod;
+}
+
+void Renderer::drawMesh(MeshType mesh, std::size_t lod)
+{
+    gpuMeshes.drawImmediate(getMeshKey(mesh, lod));
+}
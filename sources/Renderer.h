@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include "Camera.h"
+#include "Frustum.h"
+#include "GpuMeshCache.h"
+#include "InstancedRenderer.h"
+#include "MeshCache.h"
+#include "RenderQueue.h"
+#include "RenderSnapshot.h"
+
+// Tessellation used up to a given camera distance. The distance is measured
+// in multiples of the item's bounding radius, so a tier means roughly the
+// same on-screen size whatever the mesh.
+struct LodTier
+{
+	float maxDistance;
+	int slices;
+	int stacks;
+};
+
+struct RenderStats
+{
+	std::size_t visible{};
+	std::size_t culled{};
+	std::array<std::size_t, lodTierCount> perLod{};
+	std::size_t drawCalls{};
+};
+
+// Issues the GL calls for a snapshot. Must only be used on the thread that
+// owns the GL context. The immediate-mode path loads each item's whole
+// model-view-projection into the modelview matrix, so the GL projection
+// matrix is expected to stay identity.
+struct Renderer
+{
+	// Sets up the instanced path. Without it, or when the context can't run
+	// it, every item is drawn in immediate mode.
+	void init();
+	void setCamera(const Camera& newCamera);
+	void draw(const RenderSnapshot& snapshot);
+
+	// Counters of the last draw() call.
+	const RenderStats& getStats() const noexcept;
+	const MeshCacheStats& getMeshCacheStats() const noexcept;
+
+	static MeshKey getMeshKey(MeshType mesh, std::size_t lod);
+
+private:
+
+	void cull(const RenderSnapshot& snapshot);
+	std::size_t selectLod(const RenderItem& item) const;
+	void drawMesh(MeshType mesh, std::size_t lod);
+
+	MeshCache meshCache;
+	GpuMeshCache gpuMeshes{meshCache};
+
+	RenderQueue queue;
+	InstancedRenderer instanced;
+
+	Camera camera;
+	Matrix viewProjection{camera.getViewProjection()};
+	Frustum frustum{Frustum::fromMatrix(viewProjection)};
+
+	std::vector<Matrix> mvps;
+
+	std::vector<float> boundsX;
+	std::vector<float> boundsY;
+	std::vector<float> boundsZ;
+	std::vector<float> boundsRadius;
+	std::vector<std::uint8_t> visible;
+
+	RenderStats stats;
+};
@@ -0,0 +1,477 @@
+#include "ReplayLog.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+constexpr char replayMagic[4]{'L', 'W', 'Q', 'R'};
+constexpr char replayIndexMagic[4]{'L', 'W', 'Q', 'I'};
+constexpr std::uint32_t replayVersion{1};
+constexpr std::uint64_t replayHeaderSize{12};
+constexpr std::uint64_t replayTrailerSize{20};
+
+constexpr std::uint8_t keyframeKind{0};
+constexpr std::uint8_t deltaKind{1};
+
+constexpr float translationSteps{4096.f};
+constexpr float scaleSteps{4096.f};
+constexpr float orientationSteps{32767.f};
+
+static std::int32_t quantize(float v, float steps)
+{
+    const double q = std::round(double(v) * steps);
+    return static_cast<std::int32_t>(clamp(-2147483647.0, 2147483647.0, q));
+}
+
+QuantizedPose quantizePose(const ReplayPose& pose)
+{
+    const auto& t = pose.translation;
+    const auto& s = pose.scale;
+    const auto& o = pose.orientation;
+
+    return {
+        quantize(t.X, translationSteps), quantize(t.Y, translationSteps), quantize(t.Z, translationSteps),
+        quantize(s.X, scaleSteps), quantize(s.Y, scaleSteps), quantize(s.Z, scaleSteps),
+        quantize(o.w, orientationSteps), quantize(o.x, orientationSteps),
+        quantize(o.y, orientationSteps), quantize(o.z, orientationSteps)
+    };
+}
+
+ReplayPose dequantizePose(const QuantizedPose& q)
+{
+    ReplayPose r;
+
+    r.translation = {q[0] / translationSteps, q[1] / translationSteps, q[2] / translationSteps};
+    r.scale = {q[3] / scaleSteps, q[4] / scaleSteps, q[5] / scaleSteps};
+    r.orientation = {q[6] / orientationSteps, q[7] / orientationSteps,
+                     q[8] / orientationSteps, q[9] / orientationSteps};
+
+    return r;
+}
+
+static void putVarint(std::vector<std::uint8_t>& buffer, std::uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        buffer.push_back(static_cast<std::uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    buffer.push_back(static_cast<std::uint8_t>(v));
+}
+
+static bool getVarint(const std::uint8_t* data, std::size_t size, std::size_t& pos, std::uint64_t& v)
+{
+    v = 0;
+
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (pos >= size) return false;
+
+        const auto byte = data[pos++];
+        v |= std::uint64_t(byte & 0x7f) << shift;
+
+        if (!(byte & 0x80)) return true;
+    }
+
+    return false;
+}
+
+static std::uint64_t zigzag(std::int64_t v)
+{
+    return (std::uint64_t(v) << 1) ^ std::uint64_t(v >> 63);
+}
+
+static std::int64_t unzigzag(std::uint64_t v)
+{
+    return std::int64_t(v >> 1) ^ -std::int64_t(v & 1);
+}
+
+static void putFixed(std::vector<std::uint8_t>& buffer, std::uint64_t v, int bytes)
+{
+    for (int i = 0; i < bytes; ++i)
+        buffer.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+}
+
+static std::uint64_t getFixed(const std::uint8_t* data, int bytes)
+{
+    std::uint64_t v{};
+
+    for (int i = 0; i < bytes; ++i)
+        v |= std::uint64_t(data[i]) << (8 * i);
+
+    return v;
+}
+
+// Decodes one frame starting at pos into poses. Poses must hold the previous
+// frame when the frame is a delta. Returns false on truncated or corrupt data.
+static bool parseReplayFrame(const std::uint8_t* data, std::size_t size, std::size_t& pos,
+                             std::vector<QuantizedPose>& poses, bool& isKeyframe)
+{
+    if (pos >= size) return false;
+
+    const auto kind = data[pos++];
+    if (kind != keyframeKind && kind != deltaKind) return false;
+
+    isKeyframe = kind == keyframeKind;
+
+    std::uint64_t count;
+    if (!getVarint(data, size, pos, count)) return false;
+
+    if (isKeyframe)
+        poses.assign(count, QuantizedPose{});
+    else if (poses.size() != count)
+        return false;
+
+    for (auto& pose : poses)
+    {
+        std::uint64_t mask;
+        if (!getVarint(data, size, pos, mask)) return false;
+
+        for (std::size_t i = 0; i < pose.size(); ++i)
+        {
+            if (!(mask & (1u << i))) continue;
+
+            std::uint64_t v;
+            if (!getVarint(data, size, pos, v)) return false;
+
+            pose[i] = static_cast<std::int32_t>(pose[i] + unzigzag(v));
+        }
+    }
+
+    return true;
+}
+
+ReplayRecorder::ReplayRecorder(const std::string& path, std::uint32_t pKeyframeInterval)
+:
+    out{path, std::ios::binary | std::ios::trunc},
+    keyframeInterval{std::max<std::uint32_t>(1, pKeyframeInterval)},
+    queue{256},
+    stopRequested{},
+    previous{},
+    buffer{},
+    index{},
+    frameCount{},
+    bytesWritten{}
+{
+    if (!out)
+    {
+        std::cerr << "Can't open replay log " << path << std::endl;
+        return;
+    }
+
+    buffer.insert(buffer.end(), std::begin(replayMagic), std::end(replayMagic));
+    putFixed(buffer, replayVersion, 4);
+    putFixed(buffer, keyframeInterval, 4);
+
+    out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    bytesWritten = buffer.size();
+
+    writer = std::thread(&ReplayRecorder::writerLoop, this);
+}
+
+ReplayRecorder::~ReplayRecorder()
+{
+    close();
+}
+
+bool ReplayRecorder::isOpen() const noexcept
+{
+    return writer.joinable();
+}
+
+void ReplayRecorder::record(ReplayFrame&& frame)
+{
+    if (!isOpen()) return;
+
+    while (!queue.push(std::move(frame)))
+        std::this_thread::yield();
+}
+
+void ReplayRecorder::close()
+{
+    if (!isOpen()) return;
+
+    stopRequested.store(true, std::memory_order_release);
+    writer.join();
+
+    writeIndex();
+    out.close();
+}
+
+std::uint64_t ReplayRecorder::getFrameCount() const noexcept
+{
+    return frameCount.load(std::memory_order_relaxed);
+}
+
+std::uint64_t ReplayRecorder::getBytesWritten() const noexcept
+{
+    return bytesWritten.load(std::memory_order_relaxed);
+}
+
+void ReplayRecorder::writerLoop()
+{
+    ReplayFrame frame;
+
+    for (;;)
+    {
+        if (queue.pop(frame))
+        {
+            writeFrame(frame);
+            continue;
+        }
+
+        if (stopRequested.load(std::memory_order_acquire))
+        {
+            while (queue.pop(frame))
+                writeFrame(frame);
+            break;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    out.flush();
+}
+
+void ReplayRecorder::writeFrame(const ReplayFrame& frame)
+{
+    const auto frameNumber = frameCount.load(std::memory_order_relaxed);
+    const bool isKeyframe = (frameNumber % keyframeInterval == 0) || (frame.size() != previous.size());
+
+    if (isKeyframe)
+    {
+        index.emplace_back(frameNumber, bytesWritten.load(std::memory_order_relaxed));
+        previous.assign(frame.size(), QuantizedPose{});
+    }
+
+    buffer.clear();
+    buffer.push_back(isKeyframe ? keyframeKind : deltaKind);
+    putVarint(buffer, frame.size());
+
+    std::array<std::uint64_t, 10> values;
+
+    for (std::size_t i = 0; i < frame.size(); ++i)
+    {
+        auto q = quantizePose(frame[i]);
+        auto& prev = previous[i];
+
+        // q and -q are the same orientation; stay in the previous hemisphere
+        // so consecutive deltas remain small.
+        const std::int64_t dot = std::int64_t(q[6]) * prev[6] + std::int64_t(q[7]) * prev[7] +
+                                 std::int64_t(q[8]) * prev[8] + std::int64_t(q[9]) * prev[9];
+        if (dot < 0)
+        {
+            for (int k = 6; k < 10; ++k) q[k] = -q[k];
+        }
+
+        std::uint64_t mask{};
+        int valueCount{};
+
+        for (std::size_t k = 0; k < q.size(); ++k)
+        {
+            const auto delta = std::int64_t(q[k]) - prev[k];
+            if (delta == 0) continue;
+
+            mask |= 1u << k;
+            values[valueCount++] = zigzag(delta);
+        }
+
+        putVarint(buffer, mask);
+        for (int k = 0; k < valueCount; ++k)
+            putVarint(buffer, values[k]);
+
+        prev = q;
+    }
+
+    out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    bytesWritten.fetch_add(buffer.size(), std::memory_order_relaxed);
+    frameCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ReplayRecorder::writeIndex()
+{
+    const auto indexOffset = bytesWritten.load(std::memory_order_relaxed);
+
+    buffer.clear();
+    putFixed(buffer, index.size(), 8);
+    for (const auto& [frame, offset] : index)
+    {
+        putFixed(buffer, frame, 8);
+        putFixed(buffer, offset, 8);
+    }
+
+    putFixed(buffer, indexOffset, 8);
+    putFixed(buffer, frameCount.load(std::memory_order_relaxed), 8);
+    buffer.insert(buffer.end(), std::begin(replayIndexMagic), std::end(replayIndexMagic));
+
+    out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    bytesWritten.fetch_add(buffer.size(), std::memory_order_relaxed);
+}
+
+ReplayReader::ReplayReader(const std::string& path)
+:
+    in{path, std::ios::binary},
+    fileSize{},
+    dataEnd{},
+    keyframeInterval{},
+    frameCount{},
+    index{},
+    segment{},
+    segmentPos{},
+    segmentKeyframe{},
+    currentFrame{-1},
+    current{}
+{
+    if (!in) return;
+
+    in.seekg(0, std::ios::end);
+    fileSize = static_cast<std::uint64_t>(in.tellg());
+    in.seekg(0);
+
+    std::uint8_t header[replayHeaderSize];
+    if (fileSize < replayHeaderSize || !in.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        std::memcmp(header, replayMagic, 4) != 0 || getFixed(header + 4, 4) != replayVersion)
+    {
+        std::cerr << "Not a replay log: " << path << std::endl;
+        in.close();
+        return;
+    }
+
+    keyframeInterval = static_cast<std::uint32_t>(getFixed(header + 8, 4));
+
+    if (!loadIndex())
+    {
+        std::cerr << "Replay log " << path << " has no index, rebuilding it" << std::endl;
+        rebuildIndex();
+    }
+}
+
+bool ReplayReader::isOpen() const noexcept
+{
+    return in.is_open();
+}
+
+std::uint64_t ReplayReader::getFrameCount() const noexcept
+{
+    return frameCount;
+}
+
+std::uint32_t ReplayReader::getKeyframeInterval() const noexcept
+{
+    return keyframeInterval;
+}
+
+bool ReplayReader::loadIndex()
+{
+    if (fileSize < replayHeaderSize + replayTrailerSize + 8) return false;
+
+    std::uint8_t trailer[replayTrailerSize];
+    in.seekg(fileSize - replayTrailerSize);
+    if (!in.read(reinterpret_cast<char*>(trailer), sizeof(trailer))) return false;
+    if (std::memcmp(trailer + 16, replayIndexMagic, 4) != 0) return false;
+
+    const auto indexOffset = getFixed(trailer, 8);
+    if (indexOffset < replayHeaderSize || indexOffset + 8 > fileSize - replayTrailerSize) return false;
+
+    std::vector<std::uint8_t> raw(fileSize - replayTrailerSize - indexOffset);
+    in.seekg(indexOffset);
+    if (!in.read(reinterpret_cast<char*>(raw.data()), raw.size())) return false;
+
+    const auto count = getFixed(raw.data(), 8);
+    if (raw.size() != 8 + count * 16) return false;
+
+    index.resize(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        index[i].first = getFixed(raw.data() + 8 + i * 16, 8);
+        index[i].second = getFixed(raw.data() + 16 + i * 16, 8);
+    }
+
+    dataEnd = indexOffset;
+    frameCount = getFixed(trailer + 8, 8);
+    return true;
+}
+
+void ReplayReader::rebuildIndex()
+{
+    // A recorder that never reached close() leaves no index behind; walk the
+    // frames instead and stop at the last complete one.
+    index.clear();
+    frameCount = 0;
+
+    std::vector<std::uint8_t> raw(fileSize - replayHeaderSize);
+    in.clear();
+    in.seekg(replayHeaderSize);
+    in.read(reinterpret_cast<char*>(raw.data()), raw.size());
+
+    std::vector<QuantizedPose> poses;
+    std::size_t pos{};
+    std::size_t frameStart{};
+    bool isKeyframe;
+
+    while (parseReplayFrame(raw.data(), raw.size(), pos, poses, isKeyframe))
+    {
+        if (isKeyframe)
+            index.emplace_back(frameCount, replayHeaderSize + frameStart);
+
+        ++frameCount;
+        frameStart = pos;
+    }
+
+    dataEnd = replayHeaderSize + frameStart;
+}
+
+bool ReplayReader::loadSegment(std::size_t keyframe)
+{
+    const auto begin = index[keyframe].second;
+    const auto end = keyframe + 1 < index.size() ? index[keyframe + 1].second : dataEnd;
+    if (end < begin) return false;
+
+    segment.resize(end - begin);
+    in.clear();
+    in.seekg(begin);
+    if (!in.read(reinterpret_cast<char*>(segment.data()), segment.size())) return false;
+
+    segmentPos = 0;
+    segmentKeyframe = keyframe;
+    currentFrame = static_cast<std::int64_t>(index[keyframe].first) - 1;
+    return true;
+}
+
+bool ReplayReader::decodeNext()
+{
+    bool isKeyframe;
+    if (!parseReplayFrame(segment.data(), segment.size(), segmentPos, current, isKeyframe)) return false;
+
+    ++currentFrame;
+    return true;
+}
+
+bool ReplayReader::readFrame(std::uint64_t n, ReplayFrame& frame)
+{
+    if (!isOpen() || n >= frameCount || index.empty()) return false;
+
+    const auto it = std::upper_bound(index.begin(), index.end(), n,
+        [](std::uint64_t frameNumber, const std::pair<std::uint64_t, std::uint64_t>& entry)
+        {
+            return frameNumber < entry.first;
+        });
+    if (it == index.begin()) return false;
+
+    const auto keyframe = static_cast<std::size_t>(std::distance(index.begin(), it) - 1);
+    const auto target = static_cast<std::int64_t>(n);
+
+    const bool canContinue = !segment.empty() && segmentKeyframe == keyframe &&
+                             currentFrame >= 0 && currentFrame <= target;
+    if (!canContinue && !loadSegment(keyframe)) return false;
+
+    while (currentFrame < target)
+    {
+        if (!decodeNext()) return false;
+    }
+
+    frame.resize(current.size());
+    for (std::size_t i = 0; i < current.size(); ++i)
+        frame[i] = dequantizePose(current[i]);
+
+    return true;
+}
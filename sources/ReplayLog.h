@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SpscQueue.h"
+#include "Utils.h"
+
+// Replay log file layout (all integers little endian):
+//
+//   header  : "LWQR" | u32 version | u32 keyframeInterval
+//   frame   : u8 kind | varint poseCount | poseCount * pose
+//   pose    : varint changedMask | one zigzag varint per set bit
+//   index   : u64 entryCount | entryCount * (u64 frame, u64 offset)
+//   trailer : u64 indexOffset | u64 frameCount | "LWQI"
+//
+// Every pose is quantized into ten integers (translation, scale, orientation).
+// Keyframes store them against zero, delta frames against the previous frame,
+// so an actor that did not move costs one byte. Only keyframes are indexed.
+
+struct ReplayPose
+{
+	Vector translation;
+	Vector scale;
+	Quaternion orientation;
+};
+
+using ReplayFrame = std::vector<ReplayPose>;
+using QuantizedPose = std::array<std::int32_t, 10>;
+
+QuantizedPose quantizePose(const ReplayPose& pose);
+ReplayPose dequantizePose(const QuantizedPose& q);
+
+struct ReplayRecorder
+{
+	explicit ReplayRecorder(const std::string& path, std::uint32_t keyframeInterval = 60);
+	~ReplayRecorder();
+
+	ReplayRecorder(const ReplayRecorder&) = delete;
+	ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+	bool isOpen() const noexcept;
+
+	// Called from the simulation thread once per step. Blocks only when the
+	// writer thread falls a whole queue behind.
+	void record(ReplayFrame&& frame);
+
+	// Drains the queue, writes the keyframe index and closes the file.
+	void close();
+
+	std::uint64_t getFrameCount() const noexcept;
+	std::uint64_t getBytesWritten() const noexcept;
+
+private:
+
+	void writerLoop();
+	void writeFrame(const ReplayFrame& frame);
+	void writeIndex();
+
+	std::ofstream out;
+	std::uint32_t keyframeInterval;
+
+	SpscQueue<ReplayFrame> queue;
+	std::atomic<bool> stopRequested;
+	std::thread writer;
+
+	// Owned by the writer thread.
+	std::vector<QuantizedPose> previous;
+	std::vector<std::uint8_t> buffer;
+	std::vector<std::pair<std::uint64_t, std::uint64_t>> index;
+	std::atomic<std::uint64_t> frameCount;
+	std::atomic<std::uint64_t> bytesWritten;
+};
+
+struct ReplayReader
+{
+	explicit ReplayReader(const std::string& path);
+
+	bool isOpen() const noexcept;
+	std::uint64_t getFrameCount() const noexcept;
+	std::uint32_t getKeyframeInterval() const noexcept;
+
+	// Reconstructs frame n. Seeks to the closest keyframe at or before n with a
+	// binary search over the index, then applies at most keyframeInterval - 1
+	// deltas. Sequential reads continue from the previously decoded frame.
+	bool readFrame(std::uint64_t n, ReplayFrame& frame);
+
+private:
+
+	bool loadIndex();
+	void rebuildIndex();
+	bool loadSegment(std::size_t keyframe);
+	bool decodeNext();
+
+	std::ifstream in;
+	std::uint64_t fileSize;
+	std::uint64_t dataEnd;
+	std::uint32_t keyframeInterval;
+	std::uint64_t frameCount;
+	std::vector<std::pair<std::uint64_t, std::uint64_t>> index;
+
+	std::vector<std::uint8_t> segment;
+	std::size_t segmentPos;
+	std::size_t segmentKeyframe;
+	std::int64_t currentFrame;
+	std::vector<QuantizedPose> current;
+};
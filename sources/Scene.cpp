@@ -0,0 +1,44 @@
+#include "Scene.h"
+
+Scene::Scene(std::size_t initialBytes)
+:
+    arena{initialBytes},
+    actors{&arena}
+{
+
+}
+
+Scene::~Scene()
+{
+    clear();
+}
+
+void Scene::reserve(std::size_t count)
+{
+    actors.reserve(count);
+}
+
+void Scene::clear()
+{
+    for(auto it = actors.rbegin(); it != actors.rend(); ++it)
+        (*it)->~Actor();
+
+    // Drop the pointer array before its memory goes back with the arena.
+    std::pmr::vector<Actor*>{&arena}.swap(actors);
+    arena.release();
+}
+
+std::size_t Scene::size() const noexcept
+{
+    return actors.size();
+}
+
+const std::pmr::vector<Actor*>& Scene::getActors() const noexcept
+{
+    return actors;
+}
+
+std::pmr::memory_resource* Scene::getResource() noexcept
+{
+    return &arena;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+#include "Actor.h"
+
+// Owns a scene's actors. Actors and everything they allocate at construction
+// through the resource passed to them come from one monotonic arena: spawning
+// is a pointer bump, and clear() runs the actors' destructors and then hands
+// the whole arena back at once instead of freeing object by object.
+//
+// Memory an actor allocates later (a new autopilot path, say) still comes
+// from the global heap; the arena never reuses memory, so it would only grow.
+struct Scene
+{
+	explicit Scene(std::size_t initialBytes = 64 * 1024);
+	~Scene();
+
+	Scene(const Scene&) = delete;
+	Scene& operator=(const Scene&) = delete;
+
+	// Constructs T in the arena. The arena is passed as T's last constructor
+	// argument for its own allocator-aware members.
+	template<typename T, typename... Args>
+	T& spawn(Args&&... args)
+	{
+		void* memory = arena.allocate(sizeof(T), alignof(T));
+		T* actor = ::new (memory) T(std::forward<Args>(args)..., &arena);
+
+		actors.push_back(actor);
+		return *actor;
+	}
+
+	void reserve(std::size_t count);
+	void clear();
+
+	std::size_t size() const noexcept;
+	const std::pmr::vector<Actor*>& getActors() const noexcept;
+
+	std::pmr::memory_resource* getResource() noexcept;
+
+private:
+
+	std::pmr::monotonic_buffer_resource arena;
+	std::pmr::vector<Actor*> actors;
+};
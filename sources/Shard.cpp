@@ -0,0 +1,616 @@
+#include "Shard.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define LWQ_HAS_SOCKETS
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#endif
+
+// splitmix64: small state, good enough spread for picking poses.
+static std::uint64_t nextShardRandom(std::uint64_t& state) noexcept
+{
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static float nextShardFloat(std::uint64_t& state, float min, float max) noexcept
+{
+    return min + (max - min) * float(nextShardRandom(state) >> 40) * (1.f / 16777216.f);
+}
+
+static std::uint64_t mixShardHash(std::uint64_t h, std::uint64_t v) noexcept
+{
+    std::uint64_t state = h ^ v;
+    return nextShardRandom(state);
+}
+
+static std::uint32_t getFloatBits(float v) noexcept
+{
+    std::uint32_t r;
+    std::memcpy(&r, &v, sizeof(r));
+    return r;
+}
+
+// The next leg: from where the current one ends to a new random pose.
+static void retargetShardActor(ShardActor& actor, const ShardConfig& config, std::uint64_t tick)
+{
+    auto& random = actor.random;
+
+    std::copy(std::begin(actor.rotEnd), std::end(actor.rotEnd), actor.rotStart);
+    std::copy(std::begin(actor.end), std::end(actor.end), actor.start);
+
+    // Uniformly distributed rotation (Shoemake's method), as getRandomOrientation().
+    const float u1 = nextShardFloat(random, 0.f, 1.f);
+    const float u2 = nextShardFloat(random, 0.f, 2.f * float(M_PI));
+    const float u3 = nextShardFloat(random, 0.f, 2.f * float(M_PI));
+    const float a = std::sqrt(1.f - u1);
+    const float b = std::sqrt(u1);
+
+    actor.rotEnd[0] = a * std::sin(u2);
+    actor.rotEnd[1] = a * std::cos(u2);
+    actor.rotEnd[2] = b * std::sin(u3);
+    actor.rotEnd[3] = b * std::cos(u3);
+
+    for(auto& v : actor.end)
+        v = nextShardFloat(random, -config.extent, config.extent);
+
+    actor.speed = nextShardFloat(random, 0.5f, 2.f);
+    actor.mode = std::uint32_t(nextShardRandom(random) % 3);
+    actor.startTick = tick;
+}
+
+ShardActor makeShardActor(const ShardConfig& config, std::uint32_t id)
+{
+    ShardActor actor{};
+    actor.id = id;
+    actor.random = config.seed ^ (std::uint64_t(id) * 0xD1B54A32D192ED03ull);
+
+    // A random end pose, which the first leg starts from.
+    actor.rotEnd[0] = 1.f;
+    for(auto& v : actor.end)
+        v = nextShardFloat(actor.random, -config.extent, config.extent);
+
+    retargetShardActor(actor, config, 0);
+    std::copy(std::begin(actor.start), std::end(actor.start), actor.position);
+
+    return actor;
+}
+
+MotionSpec getShardMotion(const ShardActor& actor)
+{
+    MotionSpec spec;
+    spec.rotStart = {actor.rotStart[0], actor.rotStart[1], actor.rotStart[2], actor.rotStart[3]};
+    spec.rotEnd = {actor.rotEnd[0], actor.rotEnd[1], actor.rotEnd[2], actor.rotEnd[3]};
+    spec.start = {actor.start[0], actor.start[1], actor.start[2]};
+    spec.end = {actor.end[0], actor.end[1], actor.end[2]};
+    spec.speed = actor.speed;
+    spec.mode = static_cast<MotionMode>(actor.mode);
+
+    return spec;
+}
+
+// Left edge of slab k. Ownership and ghost margins both compare against this
+// one value, so a boundary is the same float on both sides.
+static float getSlabMinX(const ShardConfig& config, unsigned k) noexcept
+{
+    return -config.extent + float(k) * (2.f * config.extent / float(config.shardCount));
+}
+
+float getShardGhostMargin(const ShardConfig& config) noexcept
+{
+    // A little over the radius: a rounded distance may pass the radius test
+    // for a pair that is, exactly, a hair further apart.
+    return config.radius * 1.0625f;
+}
+
+ShardSimulation::ShardSimulation(const ShardConfig& pConfig, unsigned pIndex)
+:
+    config{pConfig},
+    index{pIndex},
+    slabWidth{2.f * pConfig.extent / float(pConfig.shardCount)},
+    minX{getSlabMinX(pConfig, pIndex)},
+    maxX{getSlabMinX(pConfig, pIndex + 1)},
+    cellsPerAxis{},
+    cellSize{},
+    actors{},
+    unsorted{},
+    points{},
+    cellStart{},
+    cellFill{},
+    checksum{},
+    neighbours{}
+{
+    // Cells at least as wide as the radius, so neighbours are at most one
+    // cell apart, and no more than maxCellsPerAxis of them along each axis.
+    constexpr int maxCellsPerAxis = 128;
+    cellsPerAxis = std::clamp(int(2.f * config.extent / config.radius), 1, maxCellsPerAxis);
+    cellSize = 2.f * config.extent / float(cellsPerAxis);
+    cellStart.resize(std::size_t(cellsPerAxis) * cellsPerAxis * cellsPerAxis + 1);
+
+    actors.reserve(config.actorCount / config.shardCount + 1);
+
+    for(std::uint32_t id = 0; id < config.actorCount; ++id)
+    {
+        const auto actor = makeShardActor(config, id);
+
+        if(getOwner(actor.position[0]) == index)
+            actors.push_back(actor);
+    }
+}
+
+unsigned ShardSimulation::getOwner(float x) const noexcept
+{
+    const int last = int(config.shardCount) - 1;
+    int k = std::clamp(int(std::floor((x + config.extent) / slabWidth)), 0, last);
+
+    // The division may round across a boundary; the edges decide.
+    while(k > 0 && x < getSlabMinX(config, unsigned(k)))
+        --k;
+    while(k < last && x >= getSlabMinX(config, unsigned(k + 1)))
+        ++k;
+
+    return unsigned(k);
+}
+
+void ShardSimulation::advance(std::uint64_t tick, std::vector<ShardActor>& toLeft, std::vector<ShardActor>& toRight)
+{
+    std::size_t kept{};
+
+    for(auto& actor : actors)
+    {
+        auto spec = getShardMotion(actor);
+
+        if(float(tick - actor.startTick) >= getMotionDuration(spec))
+        {
+            retargetShardActor(actor, config, tick);
+            spec = getShardMotion(actor);
+        }
+
+        const auto pose = sampleMotion(spec, float(tick - actor.startTick));
+        const auto& q = pose.rotation;
+        const auto& t = pose.translation;
+
+        actor.position[0] = t.X;
+        actor.position[1] = t.Y;
+        actor.position[2] = t.Z;
+
+        // A sum, so the shards' partial checksums add up to the whole.
+        std::uint64_t h = mixShardHash(actor.id, tick);
+        for(const float v : {q.w, q.x, q.y, q.z, t.X, t.Y, t.Z})
+            h = mixShardHash(h, getFloatBits(v));
+        checksum += h;
+
+        const auto owner = getOwner(t.X);
+
+        if(owner < index)
+            toLeft.push_back(actor);
+        else if(owner > index)
+            toRight.push_back(actor);
+        else
+            actors[kept++] = actor;
+    }
+
+    actors.resize(kept);
+}
+
+bool ShardSimulation::accept(const std::vector<ShardActor>& migrants)
+{
+    for(const auto& actor : migrants)
+    {
+        if(getOwner(actor.position[0]) != index)
+            return false;
+
+        actors.push_back(actor);
+    }
+
+    return true;
+}
+
+void ShardSimulation::collectGhosts(std::vector<ShardGhost>& toLeft, std::vector<ShardGhost>& toRight) const
+{
+    const bool hasLeft = index > 0;
+    const bool hasRight = index + 1 < config.shardCount;
+    const float margin = getShardGhostMargin(config);
+
+    for(const auto& actor : actors)
+    {
+        const ShardGhost ghost{actor.id, {actor.position[0], actor.position[1], actor.position[2]}};
+
+        if(hasLeft && actor.position[0] < minX + margin)
+            toLeft.push_back(ghost);
+        if(hasRight && actor.position[0] >= maxX - margin)
+            toRight.push_back(ghost);
+    }
+}
+
+int ShardSimulation::getCellCoordinate(float v) const noexcept
+{
+    // Clamping keeps motions that swing slightly out of the world in the
+    // border cells; cells only ever merge, so no pair within the radius is
+    // lost.
+    return std::clamp(int(std::floor((v + config.extent) / cellSize)), 0, cellsPerAxis - 1);
+}
+
+std::uint32_t ShardSimulation::getCell(int x, int y, int z) const noexcept
+{
+    return std::uint32_t((x * cellsPerAxis + y) * cellsPerAxis + z);
+}
+
+void ShardSimulation::query(std::uint64_t tick, const std::vector<ShardGhost>& ghosts)
+{
+    // Counting sort of actors and ghosts into the grid: cellStart[c] is the
+    // first point of cell c in `points`.
+    unsorted.clear();
+    unsorted.reserve(actors.size() + ghosts.size());
+
+    const auto addPoint = [this](std::uint32_t id, const float* p)
+    {
+        const auto cell = getCell(getCellCoordinate(p[0]), getCellCoordinate(p[1]), getCellCoordinate(p[2]));
+        unsorted.push_back({cell, id, {p[0], p[1], p[2]}});
+    };
+
+    for(const auto& actor : actors)
+        addPoint(actor.id, actor.position);
+    for(const auto& ghost : ghosts)
+        addPoint(ghost.id, ghost.position);
+
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    for(const auto& point : unsorted)
+        ++cellStart[point.cell + 1];
+    for(std::size_t c = 1; c < cellStart.size(); ++c)
+        cellStart[c] += cellStart[c - 1];
+
+    points.resize(unsorted.size());
+    cellFill.assign(cellStart.begin(), cellStart.end() - 1);
+    for(const auto& point : unsorted)
+        points[cellFill[point.cell]++] = point;
+
+    const float radiusSquared = config.radius * config.radius;
+
+    for(const auto& actor : actors)
+    {
+        const float* p = actor.position;
+        const int cx = getCellCoordinate(p[0]);
+        const int cy = getCellCoordinate(p[1]);
+        const int cz = getCellCoordinate(p[2]);
+        const int z0 = std::max(cz - 1, 0);
+        const int z1 = std::min(cz + 1, cellsPerAxis - 1);
+
+        std::uint32_t count{};
+
+        // z is the fastest-varying part of the cell index, so the cells along
+        // z are one run of points.
+        for(int x = std::max(cx - 1, 0); x <= std::min(cx + 1, cellsPerAxis - 1); ++x)
+            for(int y = std::max(cy - 1, 0); y <= std::min(cy + 1, cellsPerAxis - 1); ++y)
+            {
+                const auto end = cellStart[getCell(x, y, z1) + 1];
+
+                for(auto i = cellStart[getCell(x, y, z0)]; i < end; ++i)
+                {
+                    const auto& other = points[i];
+
+                    if(other.id == actor.id)
+                        continue;
+
+                    const float dx = other.position[0] - p[0];
+                    const float dy = other.position[1] - p[1];
+                    const float dz = other.position[2] - p[2];
+
+                    if(dx * dx + dy * dy + dz * dz <= radiusSquared)
+                        ++count;
+                }
+            }
+
+        neighbours += count;
+        checksum += mixShardHash(mixShardHash(actor.id, tick), count);
+    }
+}
+
+const std::vector<ShardActor>& ShardSimulation::getActors() const noexcept
+{
+    return actors;
+}
+
+std::uint64_t ShardSimulation::getChecksum() const noexcept
+{
+    return checksum;
+}
+
+std::uint64_t ShardSimulation::getNeighbourCount() const noexcept
+{
+    return neighbours;
+}
+
+ShardLink::ShardLink(int pFd)
+:
+    fd{pFd}
+{
+
+}
+
+ShardLink::~ShardLink()
+{
+#ifdef LWQ_HAS_SOCKETS
+    if(fd >= 0)
+        close(fd);
+#endif
+}
+
+bool ShardLink::isOpen() const noexcept
+{
+    return fd >= 0;
+}
+
+bool exchangeMessages(ShardLink* const* links, const std::vector<char>* outgoing,
+                      std::vector<char>* incoming, std::size_t count)
+{
+#ifdef LWQ_HAS_SOCKETS
+    struct Transfer
+    {
+        std::uint64_t sendHeader;
+        std::uint64_t receiveHeader;
+        std::size_t sent;
+        std::size_t received;
+    };
+
+    constexpr std::size_t headerBytes = sizeof(std::uint64_t);
+
+    std::vector<Transfer> transfers(count);
+    std::vector<pollfd> pollFds;
+    std::vector<std::size_t> pollLinks;
+
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        transfers[i] = {outgoing[i].size(), 0, 0, 0};
+        incoming[i].clear();
+    }
+
+    const auto sendDone = [&](std::size_t i) { return transfers[i].sent == headerBytes + outgoing[i].size(); };
+    const auto receiveDone = [&](std::size_t i)
+    {
+        const auto& t = transfers[i];
+        return t.received >= headerBytes && t.received == headerBytes + t.receiveHeader;
+    };
+
+    for(;;)
+    {
+        pollFds.clear();
+        pollLinks.clear();
+
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            if(links[i] == nullptr)
+                continue;
+
+            short events{};
+            if(!sendDone(i))
+                events |= POLLOUT;
+            if(!receiveDone(i))
+                events |= POLLIN;
+
+            if(events)
+            {
+                pollFds.push_back({links[i]->fd, events, 0});
+                pollLinks.push_back(i);
+            }
+        }
+
+        if(pollFds.empty())
+            return true;
+
+        if(poll(pollFds.data(), nfds_t(pollFds.size()), -1) < 0)
+        {
+            if(errno == EINTR)
+                continue;
+
+            std::cerr << "Shard link poll failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        for(std::size_t p = 0; p < pollFds.size(); ++p)
+        {
+            const auto i = pollLinks[p];
+            const auto revents = pollFds[p].revents;
+            const int fd = pollFds[p].fd;
+            auto& t = transfers[i];
+
+            if(revents & (POLLERR | POLLNVAL))
+            {
+                std::cerr << "Shard link failed" << std::endl;
+                return false;
+            }
+
+            if((revents & POLLOUT) && !sendDone(i))
+            {
+                const char* data = t.sent < headerBytes
+                    ? reinterpret_cast<const char*>(&t.sendHeader) + t.sent
+                    : outgoing[i].data() + (t.sent - headerBytes);
+                const std::size_t size = t.sent < headerBytes
+                    ? headerBytes - t.sent
+                    : outgoing[i].size() - (t.sent - headerBytes);
+
+                const auto n = send(fd, data, size, MSG_DONTWAIT | MSG_NOSIGNAL);
+
+                if(n > 0)
+                    t.sent += std::size_t(n);
+                else if(n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                {
+                    std::cerr << "Shard link send failed: " << std::strerror(errno) << std::endl;
+                    return false;
+                }
+            }
+
+            if((revents & (POLLIN | POLLHUP)) && !receiveDone(i))
+            {
+                char* data;
+                std::size_t size;
+
+                if(t.received < headerBytes)
+                {
+                    data = reinterpret_cast<char*>(&t.receiveHeader) + t.received;
+                    size = headerBytes - t.received;
+                }
+                else
+                {
+                    data = incoming[i].data() + (t.received - headerBytes);
+                    size = std::size_t(t.receiveHeader) - (t.received - headerBytes);
+                }
+
+                const auto n = recv(fd, data, size, MSG_DONTWAIT);
+
+                if(n == 0)
+                {
+                    std::cerr << "Shard link closed by the peer" << std::endl;
+                    return false;
+                }
+
+                if(n < 0)
+                {
+                    if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                    {
+                        std::cerr << "Shard link receive failed: " << std::strerror(errno) << std::endl;
+                        return false;
+                    }
+                }
+                else
+                {
+                    t.received += std::size_t(n);
+
+                    if(t.received == headerBytes)
+                        incoming[i].resize(std::size_t(t.receiveHeader));
+                }
+            }
+        }
+    }
+#else
+    (void)outgoing;
+    (void)incoming;
+
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        if(links[i] != nullptr)
+        {
+            std::cerr << "Shard links need sockets, not available on this platform" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+#endif
+}
+
+struct ShardBuffers
+{
+    std::vector<char> outgoing[2];
+    std::vector<char> incoming[2];
+};
+
+// Sends each side its records and collects what both sides sent.
+template<typename T>
+static bool exchangeRecords(ShardLink* const (&links)[2], const std::vector<T>& toLeft, const std::vector<T>& toRight,
+                            std::vector<T>& received, ShardBuffers& buffers, std::uint64_t& bytesSent)
+{
+    const std::vector<T>* sides[2]{&toLeft, &toRight};
+
+    for(int side = 0; side < 2; ++side)
+    {
+        const auto bytes = sides[side]->size() * sizeof(T);
+
+        buffers.outgoing[side].resize(bytes);
+        if(bytes > 0)
+            std::memcpy(buffers.outgoing[side].data(), sides[side]->data(), bytes);
+
+        if(links[side] != nullptr)
+            bytesSent += bytes + sizeof(std::uint64_t);
+    }
+
+    if(!exchangeMessages(links, buffers.outgoing, buffers.incoming, 2))
+        return false;
+
+    received.clear();
+
+    for(const auto& message : buffers.incoming)
+    {
+        if(message.size() % sizeof(T) != 0)
+        {
+            std::cerr << "Shard link sent a truncated record" << std::endl;
+            return false;
+        }
+
+        const auto first = received.size();
+        received.resize(first + message.size() / sizeof(T));
+
+        if(!message.empty())
+            std::memcpy(received.data() + first, message.data(), message.size());
+    }
+
+    return true;
+}
+
+bool runShard(const ShardConfig& config, unsigned index, std::uint64_t steps,
+              ShardLink* left, ShardLink* right, ShardStats& stats)
+{
+    using namespace std::chrono;
+
+    ShardSimulation shard{config, index};
+    ShardLink* const links[2]{left, right};
+
+    ShardBuffers buffers;
+    std::vector<ShardActor> toLeft;
+    std::vector<ShardActor> toRight;
+    std::vector<ShardActor> arrived;
+    std::vector<ShardGhost> ghostsLeft;
+    std::vector<ShardGhost> ghostsRight;
+    std::vector<ShardGhost> ghosts;
+
+    stats = {};
+
+    const auto start = steady_clock::now();
+
+    for(std::uint64_t tick = 1; tick <= steps; ++tick)
+    {
+        toLeft.clear();
+        toRight.clear();
+        shard.advance(tick, toLeft, toRight);
+        stats.emigrants += toLeft.size() + toRight.size();
+
+        if(!exchangeRecords(links, toLeft, toRight, arrived, buffers, stats.bytesSent))
+            return false;
+
+        if(!shard.accept(arrived))
+        {
+            std::cerr << "Shard " << index << ": an actor moved further than a slab in one step" << std::endl;
+            return false;
+        }
+
+        ghostsLeft.clear();
+        ghostsRight.clear();
+        shard.collectGhosts(ghostsLeft, ghostsRight);
+        stats.ghostsSent += ghostsLeft.size() + ghostsRight.size();
+
+        if(!exchangeRecords(links, ghostsLeft, ghostsRight, ghosts, buffers, stats.bytesSent))
+            return false;
+
+        shard.query(tick, ghosts);
+    }
+
+    stats.seconds = duration<double>(steady_clock::now() - start).count();
+    stats.steps = steps;
+    stats.neighbours = shard.getNeighbourCount();
+    stats.checksum = shard.getChecksum();
+    stats.actors = shard.getActors().size();
+
+    return true;
+}
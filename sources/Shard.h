@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "MotionSample.h"
+
+// Headless fleet simulation split into shards. The world is the cube
+// [-extent, extent]^3, cut into equal slabs along X, one per shard; each shard
+// owns the actors whose position lies in its slab. Every step a shard
+//
+//   1. advances its actors, each flying from one random pose to the next,
+//   2. hands actors that left its slab to the neighbour on that side,
+//   3. sends the neighbours ghost copies of its actors within `radius` (and a
+//      little) of the shared boundary, and
+//   4. counts, for each of its actors, the others within `radius`, ghosts
+//      included.
+//
+// Motions are drawn from a random generator carried by the actor itself, so
+// an actor flies the same course whichever shards it passes through, and the
+// checksum summed over all shards matches a single shard's bit for bit.
+
+struct ShardConfig
+{
+	std::size_t actorCount{20000};
+	float extent{100.f};
+	float radius{4.f};
+	std::uint64_t seed{1};
+	unsigned shardCount{1};
+};
+
+// An actor and its whole motion state, which is all that has to cross a
+// process boundary when it migrates. Trivially copyable; it is sent as raw
+// bytes between processes of the same build.
+struct ShardActor
+{
+	std::uint64_t random;		// generator state for the next motion
+	std::uint64_t startTick;	// of the current motion
+	std::uint32_t id;
+	std::uint32_t mode;
+	float speed;
+	float rotStart[4];
+	float rotEnd[4];
+	float start[3];
+	float end[3];
+	float position[3];			// at the last advance()
+};
+
+struct ShardGhost
+{
+	std::uint32_t id;
+	float position[3];
+};
+
+static_assert(std::is_trivially_copyable_v<ShardActor>);
+static_assert(std::is_trivially_copyable_v<ShardGhost>);
+
+ShardActor makeShardActor(const ShardConfig& config, std::uint32_t id);
+
+// How far from a boundary actors are sent as ghosts. Slabs must be at least
+// this wide, or pairs two slabs apart would be missed.
+float getShardGhostMargin(const ShardConfig& config) noexcept;
+
+// The motion the actor is flying, as sampleMotion() takes it.
+MotionSpec getShardMotion(const ShardActor& actor);
+
+struct ShardStats
+{
+	std::uint64_t steps{};
+	std::uint64_t emigrants{};
+	std::uint64_t ghostsSent{};
+	std::uint64_t bytesSent{};
+	std::uint64_t neighbours{};	// pairs within the radius, summed over steps
+	std::uint64_t checksum{};
+	std::uint64_t actors{};		// owned after the last step
+	double seconds{};			// in the step loop
+};
+
+static_assert(std::is_trivially_copyable_v<ShardStats>);
+
+struct ShardSimulation
+{
+	// Creates the actors of the whole world and keeps those starting in this
+	// shard's slab.
+	ShardSimulation(const ShardConfig& config, unsigned index);
+
+	unsigned getOwner(float x) const noexcept;
+
+	// Moves every actor to its pose at `tick` and removes the ones that left
+	// the slab, by side.
+	void advance(std::uint64_t tick, std::vector<ShardActor>& toLeft, std::vector<ShardActor>& toRight);
+
+	// False when a migrant isn't this shard's, i.e. it moved further than a
+	// slab in one step.
+	bool accept(const std::vector<ShardActor>& migrants);
+
+	void collectGhosts(std::vector<ShardGhost>& toLeft, std::vector<ShardGhost>& toRight) const;
+
+	// Neighbour counts of this step, folded into the checksum with the
+	// actors' poses.
+	void query(std::uint64_t tick, const std::vector<ShardGhost>& ghosts);
+
+	const std::vector<ShardActor>& getActors() const noexcept;
+	std::uint64_t getChecksum() const noexcept;
+	std::uint64_t getNeighbourCount() const noexcept;
+
+private:
+
+	struct Point
+	{
+		std::uint32_t cell;
+		std::uint32_t id;
+		float position[3];
+	};
+
+	std::uint32_t getCell(int x, int y, int z) const noexcept;
+	int getCellCoordinate(float v) const noexcept;
+
+	ShardConfig config;
+	unsigned index;
+	float slabWidth;
+	float minX;
+	float maxX;
+	int cellsPerAxis;
+	float cellSize;
+
+	std::vector<ShardActor> actors;
+	std::vector<Point> unsorted;
+	std::vector<Point> points;			// grouped by cell
+	std::vector<std::uint32_t> cellStart;
+	std::vector<std::uint32_t> cellFill;
+	std::uint64_t checksum;
+	std::uint64_t neighbours;
+};
+
+// One end of a connected stream socket to a neighbouring shard: a Unix domain
+// socket pair between local processes, though a connected TCP socket works
+// the same. Messages are a u64 byte count and the bytes. Owns and closes the
+// descriptor.
+struct ShardLink
+{
+	explicit ShardLink(int fd = -1);
+	~ShardLink();
+
+	ShardLink(const ShardLink&) = delete;
+	ShardLink& operator=(const ShardLink&) = delete;
+
+	bool isOpen() const noexcept;
+
+	int fd;
+};
+
+// Sends outgoing[i] over links[i] and receives one message from each link
+// into incoming[i], all at once, so two shards sending each other more than a
+// socket buffer's worth can't deadlock. Null links are skipped. False on a
+// socket error or a closed peer.
+bool exchangeMessages(ShardLink* const* links, const std::vector<char>* outgoing,
+	std::vector<char>* incoming, std::size_t count);
+
+// Runs the shard `index` for `steps` steps, exchanging migrants and ghosts
+// with its neighbours (null at the ends of the world). Reports errors and
+// returns false when the run can't continue.
+bool runShard(const ShardConfig& config, unsigned index, std::uint64_t steps,
+	ShardLink* left, ShardLink* right, ShardStats& stats);
@@ -0,0 +1,331 @@
+#pragma once
+
+#include <cmath>
+#include "Utils.h"
+
+// SSE is used wherever the compiler targets it (every x86-64 build) unless
+// LWQ_NO_SIMD is defined, which the LWQ_NO_SIMD CMake option does. Every
+// other build gets the scalar code below, with the same results up to
+// rounding.
+#if (defined(__SSE2__) || defined(_M_X64)) && !defined(LWQ_NO_SIMD)
+#define LWQ_SIMD_SSE
+#include <emmintrin.h>
+#ifdef __SSE3__
+#include <pmmintrin.h>
+#endif
+#endif
+
+#ifdef LWQ_SIMD_SSE
+
+using SimdRegister = __m128;
+
+#define LWQ_SIMD_SWIZZLE(a, x, y, z, w) _mm_shuffle_ps(a, a, (x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+
+inline SimdRegister simdSet(float x, float y, float z, float w) noexcept { return _mm_setr_ps(x, y, z, w); }
+inline SimdRegister simdSplat(float v) noexcept { return _mm_set1_ps(v); }
+inline SimdRegister simdAdd(SimdRegister a, SimdRegister b) noexcept { return _mm_add_ps(a, b); }
+inline SimdRegister simdSub(SimdRegister a, SimdRegister b) noexcept { return _mm_sub_ps(a, b); }
+inline SimdRegister simdMul(SimdRegister a, SimdRegister b) noexcept { return _mm_mul_ps(a, b); }
+inline float simdLane(SimdRegister a, int lane) noexcept
+{
+	alignas(16) float v[4];
+	_mm_store_ps(v, a);
+	return v[lane];
+}
+
+// Sum of the four lanes of a * b, in every lane.
+inline SimdRegister simdDot(SimdRegister a, SimdRegister b) noexcept
+{
+	const __m128 m = _mm_mul_ps(a, b);
+#ifdef __SSE3__
+	const __m128 s = _mm_hadd_ps(m, m);
+	return _mm_hadd_ps(s, s);
+#else
+	const __m128 s = _mm_add_ps(m, LWQ_SIMD_SWIZZLE(m, 2, 3, 0, 1));
+	return _mm_add_ps(s, LWQ_SIMD_SWIZZLE(s, 1, 0, 3, 2));
+#endif
+}
+
+// 1 / sqrt(v): the hardware estimate and one Newton-Raphson step, about as
+// accurate as the division it replaces.
+inline SimdRegister simdReciprocalSqrt(SimdRegister v) noexcept
+{
+	const __m128 y = _mm_rsqrt_ps(v);
+	const __m128 yyv = _mm_mul_ps(_mm_mul_ps(y, y), v);
+	return _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), y), _mm_sub_ps(_mm_set1_ps(3.f), yyv));
+}
+
+inline bool simdEqual(SimdRegister a, SimdRegister b) noexcept
+{
+	return _mm_movemask_ps(_mm_cmpeq_ps(a, b)) == 0xF;
+}
+
+// (a.y, a.z, a.x, a.w) and (a.z, a.x, a.y, a.w)
+inline SimdRegister simdYzx(SimdRegister a) noexcept { return LWQ_SIMD_SWIZZLE(a, 1, 2, 0, 3); }
+inline SimdRegister simdZxy(SimdRegister a) noexcept { return LWQ_SIMD_SWIZZLE(a, 2, 0, 1, 3); }
+
+#else
+
+struct alignas(16) SimdRegister
+{
+	float v[4];
+};
+
+inline SimdRegister simdSet(float x, float y, float z, float w) noexcept { return {{x, y, z, w}}; }
+inline SimdRegister simdSplat(float v) noexcept { return {{v, v, v, v}}; }
+inline SimdRegister simdAdd(SimdRegister a, SimdRegister b) noexcept
+{
+	return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+}
+inline SimdRegister simdSub(SimdRegister a, SimdRegister b) noexcept
+{
+	return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+}
+inline SimdRegister simdMul(SimdRegister a, SimdRegister b) noexcept
+{
+	return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+}
+inline float simdLane(SimdRegister a, int lane) noexcept { return a.v[lane]; }
+
+inline SimdRegister simdDot(SimdRegister a, SimdRegister b) noexcept
+{
+	return simdSplat(a.v[0] * b.v[0] + a.v[1] * b.v[1] + a.v[2] * b.v[2] + a.v[3] * b.v[3]);
+}
+
+inline SimdRegister simdReciprocalSqrt(SimdRegister v) noexcept
+{
+	return simdSplat(1.f / std::sqrt(v.v[0]));
+}
+
+inline bool simdEqual(SimdRegister a, SimdRegister b) noexcept
+{
+	return a.v[0] == b.v[0] && a.v[1] == b.v[1] && a.v[2] == b.v[2] && a.v[3] == b.v[3];
+}
+
+inline SimdRegister simdYzx(SimdRegister a) noexcept { return {{a.v[1], a.v[2], a.v[0], a.v[3]}}; }
+inline SimdRegister simdZxy(SimdRegister a) noexcept { return {{a.v[2], a.v[0], a.v[1], a.v[3]}}; }
+
+#endif
+
+inline bool isSimdEnabled() noexcept
+{
+#ifdef LWQ_SIMD_SSE
+	return true;
+#else
+	return false;
+#endif
+}
+
+// Vector held in one SIMD register. A Vector converts with w = 0, and the
+// operators keep it that way, so dot products and lengths are the 3D ones.
+struct alignas(16) Vector4
+{
+	Vector4()
+	:
+		v{simdSplat(0.f)}
+	{
+
+	}
+
+	Vector4(float x, float y, float z, float w = 0.f)
+	:
+		v{simdSet(x, y, z, w)}
+	{
+
+	}
+
+	explicit Vector4(const Vector& vector)
+	:
+		v{simdSet(vector.X, vector.Y, vector.Z, 0.f)}
+	{
+
+	}
+
+	explicit Vector4(SimdRegister pV)
+	:
+		v{pV}
+	{
+
+	}
+
+	float x() const noexcept { return simdLane(v, 0); }
+	float y() const noexcept { return simdLane(v, 1); }
+	float z() const noexcept { return simdLane(v, 2); }
+	float w() const noexcept { return simdLane(v, 3); }
+
+	Vector toVector() const noexcept
+	{
+		alignas(16) float f[4];
+		store(f);
+		return {f[0], f[1], f[2]};
+	}
+
+	void store(float* out) const noexcept
+	{
+#ifdef LWQ_SIMD_SSE
+		_mm_storeu_ps(out, v);
+#else
+		for(int i = 0; i < 4; ++i)
+			out[i] = v.v[i];
+#endif
+	}
+
+	float length() const noexcept
+	{
+		return std::sqrt(simdLane(simdDot(v, v), 0));
+	}
+
+	Vector4& operator+=(const Vector4& rhs) noexcept
+	{
+		v = simdAdd(v, rhs.v);
+		return *this;
+	}
+
+	Vector4& operator-=(const Vector4& rhs) noexcept
+	{
+		v = simdSub(v, rhs.v);
+		return *this;
+	}
+
+	Vector4 operator+(const Vector4& rhs) const noexcept
+	{
+		return Vector4{simdAdd(v, rhs.v)};
+	}
+
+	Vector4 operator-(const Vector4& rhs) const noexcept
+	{
+		return Vector4{simdSub(v, rhs.v)};
+	}
+
+	Vector4 operator*(float s) const noexcept
+	{
+		return Vector4{simdMul(v, simdSplat(s))};
+	}
+
+	bool operator==(const Vector4& rhs) const noexcept
+	{
+		return simdEqual(v, rhs.v);
+	}
+
+	bool operator!=(const Vector4& rhs) const noexcept
+	{
+		return !(*this == rhs);
+	}
+
+	SimdRegister v;
+};
+
+inline float dotProduct(const Vector4& lhs, const Vector4& rhs) noexcept
+{
+	return simdLane(simdDot(lhs.v, rhs.v), 0);
+}
+
+inline Vector4 crossProduct(const Vector4& lhs, const Vector4& rhs) noexcept
+{
+	return Vector4{simdSub(simdMul(simdYzx(lhs.v), simdZxy(rhs.v)), simdMul(simdZxy(lhs.v), simdYzx(rhs.v)))};
+}
+
+// One reciprocal square root, where normalize(Vector) divides by the length.
+inline Vector4 normalize(const Vector4& v) noexcept
+{
+	return Vector4{simdMul(v.v, simdReciprocalSqrt(simdDot(v.v, v.v)))};
+}
+
+// Quaternion held in one SIMD register as (x, y, z, w).
+struct alignas(16) Quaternion4
+{
+	Quaternion4()
+	:
+		v{simdSet(0.f, 0.f, 0.f, 1.f)}
+	{
+
+	}
+
+	Quaternion4(float w, float x, float y, float z)
+	:
+		v{simdSet(x, y, z, w)}
+	{
+
+	}
+
+	explicit Quaternion4(const Quaternion& q)
+	:
+		v{simdSet(q.x, q.y, q.z, q.w)}
+	{
+
+	}
+
+	explicit Quaternion4(SimdRegister pV)
+	:
+		v{pV}
+	{
+
+	}
+
+	float w() const noexcept { return simdLane(v, 3); }
+	float x() const noexcept { return simdLane(v, 0); }
+	float y() const noexcept { return simdLane(v, 1); }
+	float z() const noexcept { return simdLane(v, 2); }
+
+	Quaternion toQuaternion() const noexcept
+	{
+		alignas(16) float f[4];
+#ifdef LWQ_SIMD_SSE
+		_mm_store_ps(f, v);
+#else
+		for(int i = 0; i < 4; ++i)
+			f[i] = v.v[i];
+#endif
+		return {f[3], f[0], f[1], f[2]};
+	}
+
+	// Same product as Quaternion::operator*: the lanes of each operand are
+	// shuffled into place so all four components come out of four vector
+	// multiplies.
+	Quaternion4 operator*(const Quaternion4& rhs) const noexcept
+	{
+#ifdef LWQ_SIMD_SSE
+		const __m128 a = v;
+		const __m128 b = rhs.v;
+		const __m128 negateW = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, int(0x80000000u)));
+
+		const __m128 t0 = _mm_mul_ps(LWQ_SIMD_SWIZZLE(a, 3, 3, 3, 3), b);
+		const __m128 t1 = _mm_mul_ps(LWQ_SIMD_SWIZZLE(a, 0, 1, 2, 0), LWQ_SIMD_SWIZZLE(b, 3, 3, 3, 0));
+		const __m128 t2 = _mm_mul_ps(LWQ_SIMD_SWIZZLE(a, 1, 2, 0, 1), LWQ_SIMD_SWIZZLE(b, 2, 0, 1, 1));
+		const __m128 t3 = _mm_mul_ps(LWQ_SIMD_SWIZZLE(a, 2, 0, 1, 2), LWQ_SIMD_SWIZZLE(b, 1, 2, 0, 2));
+
+		return Quaternion4{_mm_sub_ps(_mm_add_ps(t0, _mm_xor_ps(_mm_add_ps(t1, t2), negateW)), t3)};
+#else
+		const auto& a = v.v;
+		const auto& b = rhs.v.v;
+
+		return Quaternion4{simdSet(
+			a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1],
+			a[3] * b[1] + a[1] * b[3] + a[2] * b[0] - a[0] * b[2],
+			a[3] * b[2] + a[2] * b[3] + a[0] * b[1] - a[1] * b[0],
+			a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2])};
+#endif
+	}
+
+	Quaternion4 operator*(float scalar) const noexcept
+	{
+		return Quaternion4{simdMul(v, simdSplat(scalar))};
+	}
+
+	bool operator==(const Quaternion4& rhs) const noexcept
+	{
+		return simdEqual(v, rhs.v);
+	}
+
+	SimdRegister v;
+};
+
+inline float QuaternionDotProduct(const Quaternion4& q1, const Quaternion4& q2) noexcept
+{
+	return simdLane(simdDot(q1.v, q2.v), 0);
+}
+
+inline Quaternion4 normalizeQuat(const Quaternion4& q) noexcept
+{
+	return Quaternion4{simdMul(q.v, simdReciprocalSqrt(simdDot(q.v, q.v)))};
+}
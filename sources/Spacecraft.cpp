@@ -1,149 +1,172 @@
 #include "Spacecraft.h"
 #include "LerpWithQuats.h"
+#include <cctype>
+#include <iterator>
 
-std::vector<std::pair<bool, std::size_t>> getInitVKeyMappings()
+// Rotation keys in the order handleInput applies them; keyRotations matches.
+constexpr unsigned char rotationKeys[6]{'x', 'X', 'y', 'Y', 'z', 'Z'};
+
+Spacecraft::Spacecraft(const Transform& pTransform, std::pmr::memory_resource* resource)
+:
+    Actor{resource},
+    pose{toPose(pTransform)},
+    velocity{},
+    track{},
+    scripted{},
+    keys{},
+    isStartSet{},
+    start{},
+    startOrientation{1.f},
+    angleOffset{5.f},
+    keyRotations{},
+    rotationsSinceNormalize{},
+    eulerAngles{},
+    eulerAnglesDirty{}
 {
-    return
+    const Vector axes[3]{{1.f, 0.f, 0.f}, {0.f, 1.f, 0.f}, {0.f, 0.f, 1.f}};
+    for(int i = 0; i < 3; ++i)
     {
-        { false, GLUT_KEY_UP },
-        { false, GLUT_KEY_DOWN },
-        { false, 'x'},
-        { false, 'X'},
-        { false, 'y'},
-        { false, 'Y'},
-        { false, 'z'},
-        { false, 'Z'}
-    };
+        keyRotations[i * 2] = makeQuatFromAxisAngle(axes[i], angleOffset);
+        keyRotations[i * 2 + 1] = makeQuatFromAxisAngle(axes[i], -angleOffset);
+    }
 }
 
-void Spacecraft::initMatrix()
+void Spacecraft::startAutopilot(float extent, float speed)
 {
-    matrix[0] = matrix[5] = matrix[10] = matrix[15] = 1.f; 
+    auto& scripts = LerpWithQuats::getScripts();
+    scripts.start(autopilot(scripts, extent, speed));
 }
 
-Spacecraft::Spacecraft(const Transform& pTransform)
-:
-    transform{pTransform},
-    interp{*this},
-    vKeyMappings{getInitVKeyMappings()},
-    isStartSet{},
-    finalLerping{},
-    eulerAngles{},
-	startAngles{},
-    endAngles{},
-    angleOffset{5.f},
-    matrix{}
+MotionScript Spacecraft::autopilot(ScriptScheduler& scripts, float extent, float speed)
 {
-    interp.addLerpEndedListener(
-    [this]
-    ()
-    {   
-        if(!finalLerping)
-        {
-            eulerAngles = startAngles;
-        }
-    });
+    scripted = true;
 
-    initMatrix();
-}
+    for(;;)
+    {
+        // Curve through a random waypoint; the path keeps the speed constant along it.
+        MotionSpec motion;
+        motion.rotStart = pose.rotation;
+        motion.rotEnd = getRandomOrientation();
+        motion.path = std::make_shared<const Path>(std::vector<Vector>{pose.translation,
+            getRandomLocation(extent), getRandomLocation(extent)}, 64);
+        motion.speed = speed;
 
-void Spacecraft::draw()
-{
-    glPushMatrix();
+        co_await scripts.play(track, std::move(motion));
 
-    const auto X = transform.translation.X;
-    const auto Y = transform.translation.Y;
-    const auto Z = transform.translation.Z;
+        setPose(track.sample(scripts.getNow()));
+    }
+}
 
-    const auto roll = eulerAngles.alpha;
-    const auto yaw = eulerAngles.beta;
-    const auto pitch = eulerAngles.gamma;
+MotionScript Spacecraft::flyBack(ScriptScheduler& scripts, MotionSpec motion)
+{
+    scripted = true;
 
-    glColor3f(1.0, 1.0, 0);
+    co_await scripts.play(track, std::move(motion));
 
-    glPushMatrix();
+    // The last sample is the exact end pose; input takes over from here.
+    setPose(track.sample(scripts.getNow()));
+    scripted = false;
+}
 
-    glTranslatef(X, Y, Z);
-    if(!interp.isLerping())
-    {
-        glRotatef(roll, 1.f, 0.f , 0.f);
-        glRotatef(yaw, 0.f, 1.f , 0.f);
-        glRotatef(pitch, 0.f, 0.f , 1.f);
-    }
-    else
-    {
-        glMultMatrixf(matrix.data());
-    }
-    
-    glutSolidCone(5.f, 10.f, 20.f, 20.f);
-    glPopMatrix();
+void Spacecraft::draw(RenderSnapshot& snapshot) const
+{
+    drawAhead(snapshot, 0);
+}
 
-    glPopMatrix();
+void Spacecraft::drawAhead(RenderSnapshot& snapshot, unsigned frames) const
+{
+    snapshot.items.push_back(makeRenderItem(
+        MeshType::Cone,
+        {1.f, 1.f, 0.f},
+        makeModelMatrix(frames > 0 ? extrapolatePose(pose, velocity, float(frames)) : pose)
+    ));
 }
 
 void Spacecraft::setEulerAngles(const EulerAngles& newEulerAngles)
 {
-    eulerAngles = newEulerAngles;
+    pose.rotation = convertEulerAnglesToQuat(newEulerAngles);
+    eulerAnglesDirty = true;
 }	
 
 EulerAngles Spacecraft::getEulerAngles() const noexcept
 {
+    if(eulerAnglesDirty)
+    {
+        eulerAngles = convertQuatToEulerAngles(pose.rotation);
+        eulerAnglesDirty = false;
+    }
+
     return eulerAngles;
 }
 
 void Spacecraft::tick(float deltaTime)
 {
-    interp.tick(deltaTime);
-    
-    if(!interp.isLerping())
-        handleInput();
-    else 
+    tickSteps(deltaTime, 1);
+}
+
+void Spacecraft::tickSteps(float, unsigned steps)
+{
+    // Scripts resume before actors tick, so the track is current; the pose
+    // is a pure function of the scheduler's time, and the steps only tell
+    // how far back the previous pose was, for drawAhead(). Keys move the
+    // spacecraft one step per call, as it did with the interpolator; the
+    // player's group ticks every frame.
+    if(scripted)
     {
-        const auto rotMatrix = interp.getRotMatrix();
-        matrix = rotMatrix.matrixInColumnForm;
+        const auto previous = pose;
+        setPose(track.sample(LerpWithQuats::getScripts().getNow()));
+        velocity = steps > 1 ? estimateVelocity(previous, pose, float(steps)) : PoseVelocity{};
+    }
+    else
+    {
+        handleInput();
+        velocity = {};
     }
+}
 
-    draw();
+bool Spacecraft::isDormant() const
+{
+    return !scripted && !keys.any();
 }
 
-void Spacecraft::setTransform(const Transform &newTransform)
+void Spacecraft::setPose(const Pose& newPose)
 {
-    transform = newTransform;
+    pose = newPose;
+    eulerAnglesDirty = true;
 }
 
-Transform Spacecraft::getTransform() const
+Pose Spacecraft::getPose() const
 {
-    return transform;
+    return pose;
 }
 
 void Spacecraft::keyInput(int key, int x, int y)
 {  
-    setKeyInBindingsTo(key, true);
+    keys.setKey(static_cast<unsigned char>(key), true);
 
     switch(key)
     {
     case ' ':
-        if(!interp.isLerping())
+        if(!scripted)
         {
-            const auto currLoc = transform.translation;
-
             if(!isStartSet)
             {
-                start = currLoc;
+                start = pose.translation;
+                startOrientation = pose.rotation;
                 isStartSet = true;
-                startAngles = eulerAngles;
             }
             else
             {
-                end = currLoc;
                 isStartSet = false;
 
-                endAngles = eulerAngles;
-                
-                const auto q1 = convertEulerAnglesToQuat(endAngles);
-                const auto q2 = convertEulerAnglesToQuat(startAngles);
+                MotionSpec motion;
+                motion.rotStart = pose.rotation;
+                motion.rotEnd = startOrientation;
+                motion.start = pose.translation;
+                motion.end = start;
 
-                interp.interpolate(q1, q2, end, start, 1.f);
+                auto& scripts = LerpWithQuats::getScripts();
+                scripts.start(flyBack(scripts, std::move(motion)));
             }
         }
         break;
@@ -153,144 +176,53 @@ void Spacecraft::keyInput(int key, int x, int y)
 }
 
 
-void Spacecraft::setKeyInBindingsTo(int key, bool down)
-{
-    auto it = std::find_if(vKeyMappings.begin(), vKeyMappings.end(),
-        [key]
-    (const std::pair<bool, std::size_t>& keyMapping)
-        {
-            return keyMapping.second == key;
-        });
-
-    if (it == std::end(vKeyMappings)) return;
-    
-    it->first = down;
-
-    if(!down)
-    {
-        int inverseKey = key > 100 ? key - 32 : key + 32;
-
-        auto itInverse = std::find_if(vKeyMappings.begin(), vKeyMappings.end(),
-            [inverseKey]
-        (const std::pair<bool, std::size_t>& keyMapping)
-            {
-                return keyMapping.second == inverseKey;
-            });
-        if (itInverse == std::end(vKeyMappings)) return;
-        else
-        {
-            it->first = down;
-            itInverse->first = down;
-        }
-    }
-}
-
 void Spacecraft::keyInputUp(unsigned char key, int x, int y)
 {
-    setKeyInBindingsTo(key, false);
+    // Shift may be released before the letter; let go of both cases.
+    keys.setKey(key, false);
+    keys.setKey(static_cast<unsigned char>(std::islower(key) ? std::toupper(key) : std::tolower(key)), false);
 }
-                                                                                                        
+
 void Spacecraft::specialDownFunc(int key, int x, int y)
 {
-    setKeyInBindingsTo(key, true);
+    keys.setSpecial(key, true);
 }
 
 void Spacecraft::specialUpFunc(int key, int x, int y)
 {
-    setKeyInBindingsTo(key, false);
+    keys.setSpecial(key, false);
 }
 
-Vector rotTransform(const std::array<float, 16> m, const Vector& v)
-{
-    Vector r;
-
-    r.X = m[0] * v.X + m[4] * v.Y + m[8] * v.Z;
-    r.Y = m[1] * v.X + m[5] * v.Y + m[9] * v.Z;
-    r.Z = m[2] * v.X + m[6] * v.Y + m[10] * v.Z;
-    
-    return r;
-}
- 
 void Spacecraft::handleInput()
 {
-     for (const auto& keyMapping : vKeyMappings)
-        {
-            if (!keyMapping.first) continue;
-
-            int key = keyMapping.second;
-
-            auto newTransform = transform;
-            auto& loc = newTransform.translation;
-            auto& rot = newTransform.rotation;
-
-            const auto q = convertEulerAnglesToQuat(eulerAngles);
-            const auto rotMatrix = q.getRotMatrix();
-
-            const Vector v{
-                0.f,
-                0.f,
-                1.f
-            };
-
-            const auto move = rotTransform(rotMatrix.matrixInColumnForm, v);
-            
-            if (key == GLUT_KEY_UP)
-            {   
-                loc.X += move.X;
-                loc.Y += move.Y;
-                loc.Z += move.Z;
-            }
-            else if (key == GLUT_KEY_DOWN)
-            {
-                loc.X -= move.X;
-                loc.Y -= move.Y;
-                loc.Z -= move.Z;
-            }
-            else if(key == 'x')
-            {    
-                eulerAngles.alpha += angleOffset;
-        
-                if(eulerAngles.alpha >= 360.f)
-                    eulerAngles.alpha -= 360.f;
-            }
-            else if(key == 'X')
-            {
-                eulerAngles.alpha -= angleOffset;
-            
-                if(eulerAngles.alpha <= -360.f)
-                    eulerAngles.alpha += 360.f;
-            }
-            else if(key == 'z')
-            {
-                eulerAngles.gamma += angleOffset;
-       
-                if(eulerAngles.gamma >= 360.f)
-                     eulerAngles.gamma -= 360.f;
-            }
-            else if(key == 'Z')
-            {
-                
-                eulerAngles.gamma -= angleOffset;
-            
-                if(eulerAngles.gamma <= -360.f)
-                    eulerAngles.gamma += 360.f;
-            }
-            else if(key == 'y')
-            {
-                eulerAngles.beta += angleOffset;
-       
-                if(eulerAngles.beta >= 360.f)
-                    eulerAngles.beta -= 360.f;
-            }
-            else if(key == 'Y')
-            {
-                eulerAngles.beta -= angleOffset;
-            
-                if(eulerAngles.beta <= -360.f)
-                    eulerAngles.beta += 360.f;
+    // Renormalize every so often instead of after each rotation; the drift
+    // of a few dozen unit-quaternion products is far below float precision.
+    constexpr unsigned normalizeInterval{32};
 
-            }
+    if (!keys.any()) return;
 
-            transform = newTransform;
-        }
+    if (keys.isSpecialDown(GLUT_KEY_UP))
+    {
+        pose.translation += rotateVector(pose.rotation, {0.f, 0.f, 1.f});
+    }
+
+    if (keys.isSpecialDown(GLUT_KEY_DOWN))
+    {
+        pose.translation -= rotateVector(pose.rotation, {0.f, 0.f, 1.f});
+    }
+
+    for (std::size_t i = 0; i < std::size(rotationKeys); ++i)
+    {
+        if (!keys.isKeyDown(rotationKeys[i])) continue;
+
+        pose.rotation = pose.rotation * keyRotations[i];
+        eulerAnglesDirty = true;
+        ++rotationsSinceNormalize;
+    }
+
+    if (rotationsSinceNormalize >= normalizeInterval)
+    {
+        pose.rotation = fastNormalizeQuat(pose.rotation);
+        rotationsSinceNormalize = 0;
+    }
 }
\ No newline at end of file
@@ -1,46 +1,68 @@
 #pragma once
 
 #include "Actor.h"
-#include "Interpolator.h"
+#include "MotionScript.h"
+#include "KeyState.h"
+#include "DeadReckoning.h"
 
 struct Spacecraft : Actor
 {
-	explicit Spacecraft(const Transform& pTransform);
+	explicit Spacecraft(const Transform& pTransform,
+		std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
 	void tick(float deltaTime) override;
-	void setTransform(const Transform& newTransform) override;
-	Transform getTransform() const override;
+	void tickSteps(float deltaTime, unsigned steps) override;
+
+	// Neither interpolating nor holding a key: wakes on the next input event.
+	bool isDormant() const override;
+	void draw(RenderSnapshot& snapshot) const override;
+
+	// Extrapolated from the last two ticked poses while scripted.
+	void drawAhead(RenderSnapshot& snapshot, unsigned frames) const override;
+	void setPose(const Pose& newPose) override;
+	Pose getPose() const override;
 	void keyInput(int key, int x, int y);
 	void keyInputUp(unsigned char key, int x, int y);
 	void specialDownFunc(int key, int x, int y);
 	void specialUpFunc(int key, int x, int y);
 	
 	void setEulerAngles(const EulerAngles& newEulerAngles);
+
+	// Keeps flying to random poses inside a cube of the given half extent,
+	// choosing the next one each time the current motion ends.
+	void startAutopilot(float extent, float speed);
+
+	// Derived from the orientation on demand, for display only.
 	EulerAngles getEulerAngles() const noexcept;
 
 private:
 
-	Transform transform;
-	Interpolator interp;
-	std::vector< std::pair<bool, std::size_t> > vKeyMappings;
+	// Translation and unit quaternion orientation. Rotation keys compose small
+	// local-axis rotations onto it, so there are no Euler angles to wrap and no
+	// gimbal lock; while a script runs, it is sampled from the track instead.
+	Pose pose;
+	PoseVelocity velocity;	// per frame, between the last two ticks of a slow group
+	MotionTrack track;
+	bool scripted;
+	KeyState keys;
 
+	// First space press marks where to fly back to on the second.
 	bool isStartSet;
 	Vector start;
-	Vector end;
-
-	bool finalLerping;
-
-	EulerAngles eulerAngles;
-	EulerAngles startAngles;
-	EulerAngles endAngles;
+	Quaternion startOrientation;
 
 	float angleOffset;
 
-	std::array<float, 16> matrix;
+	// Delta rotations for x, X, y, Y, z, Z.
+	std::array<Quaternion, 6> keyRotations;
+	unsigned rotationsSinceNormalize;
+
+	mutable EulerAngles eulerAngles;
+	mutable bool eulerAnglesDirty;
 
-	void initMatrix();
-	void draw();
 	void handleInput();
-	void setKeyInBindingsTo(int key, bool down);
+
+	MotionScript flyBack(ScriptScheduler& scripts, MotionSpec motion);
+	MotionScript autopilot(ScriptScheduler& scripts, float extent, float speed);
 };
 	
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Bounded single-producer/single-consumer queue. Slots are allocated once in
+// the constructor; push and pop never allocate and never take a lock.
+template<typename T>
+struct SpscQueue
+{
+	explicit SpscQueue(std::size_t capacity)
+		:
+		slots(roundUpToPowerOfTwo(capacity)),
+		mask{slots.size() - 1},
+		head{},
+		cachedTail{},
+		tail{},
+		cachedHead{}
+	{
+
+	}
+
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+	// Producer side. Returns false when the queue is full.
+	bool push(T&& value)
+	{
+		const auto t = tail.load(std::memory_order_relaxed);
+
+		if (t - cachedHead == slots.size())
+		{
+			cachedHead = head.load(std::memory_order_acquire);
+			if (t - cachedHead == slots.size()) return false;
+		}
+
+		slots[t & mask] = std::move(value);
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool push(const T& value)
+	{
+		T copy{value};
+		return push(std::move(copy));
+	}
+
+	// Consumer side. Returns false when the queue is empty.
+	bool pop(T& out)
+	{
+		const auto h = head.load(std::memory_order_relaxed);
+
+		if (h == cachedTail)
+		{
+			cachedTail = tail.load(std::memory_order_acquire);
+			if (h == cachedTail) return false;
+		}
+
+		out = std::move(slots[h & mask]);
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool empty() const noexcept
+	{
+		return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+	}
+
+	std::size_t capacity() const noexcept
+	{
+		return slots.size();
+	}
+
+private:
+
+	static std::size_t roundUpToPowerOfTwo(std::size_t v)
+	{
+		std::size_t r{1};
+		while (r < v) r <<= 1;
+		return r;
+	}
+
+	std::vector<T> slots;
+	const std::size_t mask;
+
+	alignas(64) std::atomic<std::size_t> head;
+	std::size_t cachedTail;
+
+	alignas(64) std::atomic<std::size_t> tail;
+	std::size_t cachedHead;
+};
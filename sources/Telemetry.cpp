@@ -0,0 +1,250 @@
+#include "Telemetry.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LWQ_HAS_SHM
+#endif
+
+// The frame is copied as 64-bit words through atomics, so a torn read is a
+// detected retry rather than a data race.
+constexpr std::size_t telemetryFrameWords = sizeof(TelemetryFrame) / sizeof(std::uint64_t);
+
+static_assert(sizeof(TelemetryFrame) % sizeof(std::uint64_t) == 0);
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared between processes");
+
+struct alignas(64) TelemetryHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t frameBytes;
+    std::uint32_t slotCount;
+    std::atomic<std::uint64_t> writeCount;
+};
+
+struct alignas(64) TelemetrySlot
+{
+    std::atomic<std::uint64_t> sequence;
+    std::atomic<std::uint64_t> words[telemetryFrameWords];
+};
+
+constexpr char telemetryMagic[4]{'L', 'W', 'Q', 'T'};
+
+static std::size_t getTelemetryBytes(std::uint32_t slotCount) noexcept
+{
+    return sizeof(TelemetryHeader) + sizeof(TelemetrySlot) * slotCount;
+}
+
+TelemetryWriter::TelemetryWriter(const std::string& pName, std::uint32_t slotCount)
+:
+    name{pName},
+    memory{},
+    bytes{getTelemetryBytes(slotCount)}
+{
+#ifdef LWQ_HAS_SHM
+    const int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+
+    if(fd < 0 || ftruncate(fd, off_t(bytes)) != 0)
+    {
+        std::cerr << "Can't create telemetry segment " << name << ": " << std::strerror(errno) << std::endl;
+
+        if(fd >= 0)
+            close(fd);
+
+        return;
+    }
+
+    void* mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if(mapped == MAP_FAILED)
+    {
+        std::cerr << "Can't map telemetry segment " << name << ": " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    // A segment left behind by a crashed run starts over; the magic goes in
+    // last so readers never see a half-initialized header as valid.
+    std::memset(mapped, 0, bytes);
+
+    auto* header = new(mapped) TelemetryHeader{};
+    header->version = telemetryVersion;
+    header->frameBytes = sizeof(TelemetryFrame);
+    header->slotCount = slotCount;
+
+    auto* slots = reinterpret_cast<TelemetrySlot*>(header + 1);
+    for(std::uint32_t i = 0; i < slotCount; ++i)
+        new(slots + i) TelemetrySlot{};
+
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, telemetryMagic, sizeof(telemetryMagic));
+
+    memory = mapped;
+#else
+    std::cerr << "Telemetry needs POSIX shared memory, not available on this platform" << std::endl;
+#endif
+}
+
+TelemetryWriter::~TelemetryWriter()
+{
+#ifdef LWQ_HAS_SHM
+    if(memory == nullptr)
+        return;
+
+    munmap(memory, bytes);
+    shm_unlink(name.c_str());
+#endif
+}
+
+bool TelemetryWriter::isOpen() const noexcept
+{
+    return memory != nullptr;
+}
+
+void TelemetryWriter::publish(const TelemetryFrame& frame) noexcept
+{
+    if(memory == nullptr)
+        return;
+
+    auto* header = static_cast<TelemetryHeader*>(memory);
+    auto* slots = reinterpret_cast<TelemetrySlot*>(header + 1);
+
+    const auto index = header->writeCount.load(std::memory_order_relaxed);
+    auto& slot = slots[index % header->slotCount];
+
+    std::uint64_t words[telemetryFrameWords];
+    std::memcpy(words, &frame, sizeof(frame));
+
+    const auto sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for(std::size_t i = 0; i < telemetryFrameWords; ++i)
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    header->writeCount.store(index + 1, std::memory_order_release);
+}
+
+TelemetryReader::TelemetryReader(const std::string& name)
+:
+    memory{},
+    bytes{}
+{
+#ifdef LWQ_HAS_SHM
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+
+    if(fd < 0)
+    {
+        std::cerr << "Can't open telemetry segment " << name << ": " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    struct stat st{};
+    if(fstat(fd, &st) != 0 || std::size_t(st.st_size) < sizeof(TelemetryHeader))
+    {
+        std::cerr << "Telemetry segment " << name << " is too small" << std::endl;
+        close(fd);
+        return;
+    }
+
+    void* mapped = mmap(nullptr, std::size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if(mapped == MAP_FAILED)
+    {
+        std::cerr << "Can't map telemetry segment " << name << ": " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    const auto* header = static_cast<const TelemetryHeader*>(mapped);
+
+    if(std::memcmp(header->magic, telemetryMagic, sizeof(telemetryMagic)) != 0 ||
+       header->version != telemetryVersion || header->frameBytes != sizeof(TelemetryFrame) ||
+       getTelemetryBytes(header->slotCount) > std::size_t(st.st_size))
+    {
+        std::cerr << "Telemetry segment " << name << " has an unknown layout" << std::endl;
+        munmap(mapped, std::size_t(st.st_size));
+        return;
+    }
+
+    memory = mapped;
+    bytes = std::size_t(st.st_size);
+#else
+    std::cerr << "Telemetry needs POSIX shared memory, not available on this platform" << std::endl;
+#endif
+}
+
+TelemetryReader::~TelemetryReader()
+{
+#ifdef LWQ_HAS_SHM
+    if(memory != nullptr)
+        munmap(const_cast<void*>(memory), bytes);
+#endif
+}
+
+bool TelemetryReader::isOpen() const noexcept
+{
+    return memory != nullptr;
+}
+
+std::uint32_t TelemetryReader::getSlotCount() const noexcept
+{
+    return memory ? static_cast<const TelemetryHeader*>(memory)->slotCount : 0;
+}
+
+std::uint64_t TelemetryReader::getWriteCount() const noexcept
+{
+    return memory ? static_cast<const TelemetryHeader*>(memory)->writeCount.load(std::memory_order_acquire) : 0;
+}
+
+bool TelemetryReader::read(std::uint64_t index, TelemetryFrame& out) const noexcept
+{
+    constexpr int attempts = 4;
+
+    if(memory == nullptr)
+        return false;
+
+    const auto* header = static_cast<const TelemetryHeader*>(memory);
+    const auto* slots = reinterpret_cast<const TelemetrySlot*>(header + 1);
+    const std::uint64_t slotCount = header->slotCount;
+
+    const auto written = header->writeCount.load(std::memory_order_acquire);
+    if(index >= written || written - index > slotCount)
+        return false;
+
+    // The slot's sequence once frame `index` is complete: two per lap.
+    const std::uint64_t expected = 2 * (index / slotCount + 1);
+    const auto& slot = slots[index % slotCount];
+
+    for(int attempt = 0; attempt < attempts; ++attempt)
+    {
+        const auto before = slot.sequence.load(std::memory_order_acquire);
+
+        if(before > expected)
+            return false;
+
+        if(before != expected)
+            continue;
+
+        std::uint64_t words[telemetryFrameWords];
+        for(std::size_t i = 0; i < telemetryFrameWords; ++i)
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if(slot.sequence.load(std::memory_order_relaxed) == before)
+        {
+            std::memcpy(&out, words, sizeof(out));
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+// Telemetry shared memory layout (POSIX shm, native endianness):
+//
+//   header : "LWQT" | u32 version | u32 frameBytes | u32 slotCount
+//            | u64 writeCount | padding to 64 bytes
+//   slot   : u64 sequence | frameBytes of TelemetryFrame | padding to 64 bytes
+//
+// writeCount is the number of frames published; frame i lives in slot
+// i % slotCount. Each slot is a seqlock: the writer makes its sequence odd,
+// writes the frame, then makes it even again. A reader copies the frame and
+// keeps it only if the sequence was the same even value before and after.
+// Fields are only ever appended, with a version bump.
+
+struct TelemetryFrame
+{
+	std::uint64_t frame{};
+	std::int64_t timestampNs{};		// steady clock
+
+	float frameMs{};				// since the previous simulation step
+	float stepMs{};					// whole step, the phases below included
+	float inputMs{};
+	float scriptsMs{};
+	float tickMs{};
+	float recordMs{};
+	float snapshotMs{};
+
+	std::uint32_t actors{};
+	std::uint32_t tickedActors{};
+	std::uint32_t sleepingActors{};
+	std::uint32_t activeMotions{};	// live motion scripts
+	std::uint32_t resumedScripts{};
+	std::uint32_t renderItems{};
+	std::uint32_t reserved{};
+
+	std::uint64_t allocations{};	// during this step
+	std::uint64_t totalAllocations{};
+};
+
+static_assert(std::is_trivially_copyable_v<TelemetryFrame>);
+static_assert(sizeof(TelemetryFrame) == 88, "TelemetryFrame layout is shared with readers");
+
+constexpr std::uint32_t telemetryVersion{1};
+
+// Publishes frames into the ring. Creates (or takes over) the named segment
+// and removes the name again on destruction. publish() is a handful of
+// stores, no system call.
+struct TelemetryWriter
+{
+	explicit TelemetryWriter(const std::string& name, std::uint32_t slotCount = 1024);
+	~TelemetryWriter();
+
+	TelemetryWriter(const TelemetryWriter&) = delete;
+	TelemetryWriter& operator=(const TelemetryWriter&) = delete;
+
+	bool isOpen() const noexcept;
+
+	void publish(const TelemetryFrame& frame) noexcept;
+
+private:
+
+	std::string name;
+	void* memory;
+	std::size_t bytes;
+};
+
+// Maps an existing ring read-only. Never blocks the writer.
+struct TelemetryReader
+{
+	explicit TelemetryReader(const std::string& name);
+	~TelemetryReader();
+
+	TelemetryReader(const TelemetryReader&) = delete;
+	TelemetryReader& operator=(const TelemetryReader&) = delete;
+
+	bool isOpen() const noexcept;
+
+	std::uint32_t getSlotCount() const noexcept;
+	std::uint64_t getWriteCount() const noexcept;
+
+	// Copies frame `index` (0-based publish order). False if it is not
+	// published yet, already overwritten, or still being overwritten after a
+	// few retries.
+	bool read(std::uint64_t index, TelemetryFrame& out) const noexcept;
+
+private:
+
+	const void* memory;
+	std::size_t bytes;
+};
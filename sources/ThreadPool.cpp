@@ -0,0 +1,134 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <utility>
+
+ThreadPool::ThreadPool(unsigned threadCount)
+:
+    workers{},
+    job{},
+    jobCount{},
+    jobGrain{1},
+    nextChunk{},
+    busyWorkers{},
+    failure{},
+    generation{},
+    stopping{}
+{
+    if(threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    workers.reserve(threadCount - 1);
+    for(unsigned i = 1; i < threadCount; ++i)
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+
+    wake.notify_all();
+
+    for(auto& worker : workers)
+        worker.join();
+}
+
+unsigned ThreadPool::getThreadCount() const noexcept
+{
+    return static_cast<unsigned>(workers.size()) + 1;
+}
+
+void ThreadPool::parallelFor(std::size_t count, std::size_t grain,
+                             const std::function<void(std::size_t, std::size_t)>& body)
+{
+    if(count == 0)
+        return;
+
+    grain = std::max<std::size_t>(grain, 1);
+
+    // Not worth waking anybody for a single chunk.
+    if(workers.empty() || count <= grain)
+    {
+        body(0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> callLock{callMutex};
+
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        job = &body;
+        jobCount = count;
+        jobGrain = grain;
+        nextChunk.store(0, std::memory_order_relaxed);
+        busyWorkers = static_cast<unsigned>(workers.size());
+        failure = nullptr;
+        ++generation;
+    }
+
+    wake.notify_all();
+    runChunks();
+
+    std::unique_lock<std::mutex> lock{mutex};
+    done.wait(lock, [this] { return busyWorkers == 0; });
+    job = nullptr;
+
+    if(failure)
+        std::rethrow_exception(std::exchange(failure, nullptr));
+}
+
+void ThreadPool::workerLoop()
+{
+    std::uint64_t seen = 0;
+
+    for(;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            wake.wait(lock, [this, seen] { return stopping || generation != seen; });
+
+            if(stopping)
+                return;
+
+            seen = generation;
+        }
+
+        runChunks();
+
+        std::lock_guard<std::mutex> lock{mutex};
+        if(--busyWorkers == 0)
+            done.notify_one();
+    }
+}
+
+void ThreadPool::runChunks()
+{
+    const auto chunks = (jobCount + jobGrain - 1) / jobGrain;
+
+    for(;;)
+    {
+        const auto chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+        if(chunk >= chunks)
+            return;
+
+        const auto begin = chunk * jobGrain;
+
+        try
+        {
+            (*job)(begin, std::min(begin + jobGrain, jobCount));
+        }
+        catch(...)
+        {
+            // Workers must not unwind out of their loop, and the caller must
+            // not leave parallelFor() while they still use body.
+            std::lock_guard<std::mutex> lock{mutex};
+            if(!failure)
+                failure = std::current_exception();
+
+            nextChunk.store(chunks, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel loops. parallelFor() splits
+// [0, count) into chunks of `grain` items that the workers and the calling
+// thread pull from a shared counter, and returns once all of them are done.
+// One loop runs at a time; calls from several threads are serialized.
+// If body throws, the remaining chunks are skipped and the first exception is
+// rethrown from parallelFor() once no thread is inside body any more.
+struct ThreadPool
+{
+	// threadCount includes the calling thread; 0 means one per hardware thread.
+	explicit ThreadPool(unsigned threadCount = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	unsigned getThreadCount() const noexcept;
+
+	void parallelFor(std::size_t count, std::size_t grain,
+	                 const std::function<void(std::size_t begin, std::size_t end)>& body);
+
+private:
+
+	void workerLoop();
+	void runChunks();
+
+	std::vector<std::thread> workers;
+
+	std::mutex callMutex;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+
+	const std::function<void(std::size_t, std::size_t)>* job;
+	std::size_t jobCount;
+	std::size_t jobGrain;
+	std::atomic<std::size_t> nextChunk;
+	unsigned busyWorkers;
+	std::exception_ptr failure;
+	std::uint64_t generation;
+	bool stopping;
+};
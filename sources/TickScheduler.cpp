@@ -0,0 +1,121 @@
+#include "TickScheduler.h"
+#include "Actor.h"
+#include <chrono>
+
+std::size_t TickScheduler::addGroup(const std::string& name, unsigned interval)
+{
+    groups.push_back({interval, {}, {}});
+
+    TickGroupStats s;
+    s.name = name;
+    s.interval = interval;
+    stats.push_back(s);
+
+    return groups.size() - 1;
+}
+
+void TickScheduler::add(Actor& actor, std::size_t group)
+{
+    auto& g = groups[group];
+
+    actor.tickGroup = static_cast<std::uint32_t>(group);
+    actor.tickSlot = static_cast<std::uint32_t>(g.actors.size());
+
+    g.actors.push_back(&actor);
+    g.awake.push_back(g.interval != 0);
+    ++stats[group].actors;
+}
+
+void TickScheduler::wake(Actor& actor)
+{
+    if(actor.tickGroup < groups.size())
+        groups[actor.tickGroup].awake[actor.tickSlot] = 1;
+}
+
+void TickScheduler::clear()
+{
+    for(const auto& g : groups)
+        for(auto* actor : g.actors)
+            actor->tickGroup = Actor::noTickGroup;
+
+    groups.clear();
+    stats.clear();
+}
+
+void TickScheduler::tick(std::uint64_t frame, float deltaTime)
+{
+    using namespace std::chrono;
+
+    for(std::size_t i = 0; i < groups.size(); ++i)
+    {
+        auto& g = groups[i];
+        auto& s = stats[i];
+
+        const auto start = steady_clock::now();
+        std::size_t ticked = 0;
+        std::size_t sleeping = 0;
+
+        for(std::size_t slot = 0; slot < g.actors.size(); ++slot)
+        {
+            if(!g.awake[slot])
+            {
+                ++sleeping;
+                continue;
+            }
+
+            auto& actor = *g.actors[slot];
+
+            if(g.interval <= 1)
+            {
+                actor.tick(deltaTime);
+            }
+            else
+            {
+                if((frame + slot) % g.interval != 0)
+                    continue;
+
+                actor.tickSteps(deltaTime * float(g.interval), g.interval);
+            }
+
+            ++ticked;
+
+            if(g.interval == 0 || actor.isDormant())
+                g.awake[slot] = 0;
+        }
+
+        const double ms = duration<double, std::milli>(steady_clock::now() - start).count();
+
+        s.sleeping = sleeping;
+        s.ticked = ticked;
+        s.totalTicked += ticked;
+        s.milliseconds = ms;
+        s.totalMilliseconds += ms;
+    }
+}
+
+const std::vector<TickGroupStats>& TickScheduler::getStats() const noexcept
+{
+    return stats;
+}
+
+unsigned TickScheduler::getFramesSinceTick(const Actor& actor, std::uint64_t frame) const noexcept
+{
+    if(actor.tickGroup >= groups.size())
+        return 0;
+
+    const auto& g = groups[actor.tickGroup];
+
+    if(g.interval <= 1 || !g.awake[actor.tickSlot])
+        return 0;
+
+    return unsigned((frame + actor.tickSlot) % g.interval);
+}
+
+bool TickScheduler::anyTicked() const noexcept
+{
+    for(const auto& s : stats)
+        if(s.ticked > 0)
+            return true;
+
+    return false;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct Actor;
+
+struct TickGroupStats
+{
+	std::string name;
+	unsigned interval{};
+	std::size_t actors{};
+	std::size_t sleeping{};
+	std::size_t ticked{};
+	std::uint64_t totalTicked{};
+	double milliseconds{};
+	double totalMilliseconds{};
+};
+
+// Ticks actors in groups with their own rates. A group with interval N ticks
+// each member every N frames, staggered by member so the cost is spread, and
+// passes N as the step count; interval 0 means event-driven only, members
+// tick only after wake(). An actor that reports isDormant() after its tick
+// sleeps until wake(), whatever its group.
+struct TickScheduler
+{
+	std::size_t addGroup(const std::string& name, unsigned interval);
+
+	void add(Actor& actor, std::size_t group);
+	void wake(Actor& actor);
+	void clear();
+
+	void tick(std::uint64_t frame, float deltaTime);
+
+	const std::vector<TickGroupStats>& getStats() const noexcept;
+
+	// Whether the last tick() ticked any actor at all.
+	bool anyTicked() const noexcept;
+
+	// Frames since the actor's last tick as of tick(frame): 0 when it ticked
+	// in that frame, belongs to a group ticking every frame, or sleeps.
+	unsigned getFramesSinceTick(const Actor& actor, std::uint64_t frame) const noexcept;
+
+private:
+
+	struct Group
+	{
+		unsigned interval;
+		std::vector<Actor*> actors;
+		std::vector<std::uint8_t> awake;
+	};
+
+	std::vector<Group> groups;
+	std::vector<TickGroupStats> stats;
+};
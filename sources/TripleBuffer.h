@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free triple buffer between one producer and one consumer. The producer
+// fills back() and publishes it; the consumer picks up the latest published
+// buffer with acquire() and reads it through front(). Neither side ever waits
+// for the other, and a buffer is never written while it is being read.
+template<typename T>
+struct TripleBuffer
+{
+	TripleBuffer()
+		:
+		buffers{},
+		middle{1},
+		backIndex{2},
+		frontIndex{0}
+	{
+
+	}
+
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+	// Producer side. The returned buffer holds whatever was published two
+	// swaps ago and must be overwritten completely.
+	T& back() noexcept
+	{
+		return buffers[backIndex];
+	}
+
+	void publish() noexcept
+	{
+		const auto previous = middle.exchange(backIndex | freshBit, std::memory_order_acq_rel);
+		backIndex = previous & indexMask;
+	}
+
+	// Consumer side. Returns true when a newer buffer became the front one.
+	bool acquire() noexcept
+	{
+		if (!(middle.load(std::memory_order_relaxed) & freshBit)) return false;
+
+		const auto previous = middle.exchange(frontIndex, std::memory_order_acq_rel);
+		frontIndex = previous & indexMask;
+		return true;
+	}
+
+	const T& front() const noexcept
+	{
+		return buffers[frontIndex];
+	}
+
+private:
+
+	static constexpr std::uint8_t freshBit{4};
+	static constexpr std::uint8_t indexMask{3};
+
+	T buffers[3];
+	std::atomic<std::uint8_t> middle;
+	std::uint8_t backIndex;
+	std::uint8_t frontIndex;
+};
@@ -2,12 +2,11 @@
 
 	#define _USE_MATH_DEFINES
 
-	#include <GL/glew.h>
-	#include <GL/freeglut.h> 
 	#include <iostream>
 	#include <math.h>
 	#include <random>
 	#include <memory>
+	#include <array>
 
 	struct Vector
 	{
@@ -27,12 +26,18 @@
 
 	Vector& operator+=(const Vector& rhs) noexcept
 	{
-		return *this = *this + rhs;;
+		X += rhs.X;
+		Y += rhs.Y;
+		Z += rhs.Z;
+		return *this;
 	}
 
 	Vector& operator-=(const Vector& rhs) noexcept
 	{
-		return *this = *this - rhs;;
+		X -= rhs.X;
+		Y -= rhs.Y;
+		Z -= rhs.Z;
+		return *this;
 	}
 
 	Vector operator+(const Vector& rhs) const noexcept
@@ -75,7 +80,8 @@
 
 	inline Vector normalize(const Vector& v)
 	{
-	return { v.X / v.length(), v.Y / v.length(), v.Z / v.length() };
+	const float length = v.length();
+	return { v.X / length, v.Y / length, v.Z / length };
 	}
 
 	inline float dotProduct(const Vector& lhs, const Vector& rhs)
@@ -83,6 +89,15 @@
 		return lhs.X * rhs.X + lhs.Y * rhs.Y + lhs.Z * rhs.Z;
 	}
 
+	inline Vector crossProduct(const Vector& lhs, const Vector& rhs)
+	{
+		return {
+			lhs.Y * rhs.Z - lhs.Z * rhs.Y,
+			lhs.Z * rhs.X - lhs.X * rhs.Z,
+			lhs.X * rhs.Y - lhs.Y * rhs.X
+		};
+	}
+
 	inline bool inRange(float min, float max, float v)
 	{
 	return (min <= v) && (v <= max);
@@ -99,11 +114,7 @@
 
 	inline Vector getUnitVector(const Vector& v)
 	{
-		return {
-			v.X / v.length(),
-			v.Y / v.length(),
-			v.Z / v.length()
-		};
+		return normalize(v);
 	}
 
 	template<typename T>
@@ -268,6 +279,25 @@
 		float z;
 	};
 
+	// Column-major translation * rotation * scale, laid out for glMultMatrixf.
+	inline std::array<float, 16> makeModelMatrix(const Vector& translation, const RotationMatrix& rotation,
+		const Vector& scale = {1.f, 1.f, 1.f})
+	{
+		auto m = rotation.matrixInColumnForm;
+		const float s[3]{scale.X, scale.Y, scale.Z};
+
+		for(int col = 0; col < 3; ++col)
+			for(int row = 0; row < 3; ++row)
+				m[col * 4 + row] *= s[col];
+
+		m[12] = translation.X;
+		m[13] = translation.Y;
+		m[14] = translation.Z;
+		m[15] = 1.f;
+
+		return m;
+	}
+
 	inline Quaternion convertEulerAnglesToQuat(const EulerAngles& e)
 	{
 		const float alpha = toRadians(e.alpha);
@@ -288,11 +318,94 @@
 			q1.z * q2.z);
 	}
 
+	inline Quaternion normalizeQuat(const Quaternion& q)
+	{
+		return q * (1.f / std::sqrt(QuaternionDotProduct(q, q)));
+	}
+
+	// First-order renormalization, accurate while |q| stays close to 1. Enough
+	// to undo the drift of a few dozen small incremental rotations.
+	inline Quaternion fastNormalizeQuat(const Quaternion& q)
+	{
+		return q * (0.5f * (3.f - QuaternionDotProduct(q, q)));
+	}
+
+	inline Quaternion conjugateQuat(const Quaternion& q)
+	{
+		return Quaternion(q.w, -q.x, -q.y, -q.z);
+	}
+
+	// Logarithm of a unit quaternion: the rotation axis scaled by half the
+	// angle, in radians. quatExp is its inverse.
+	inline Vector quatLog(const Quaternion& q)
+	{
+		const float v = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z);
+
+		if (v < 1e-7f)
+			return {q.x, q.y, q.z};
+
+		const float halfAngle = std::atan2(v, q.w);
+		const float s = halfAngle / v;
+
+		return {q.x * s, q.y * s, q.z * s};
+	}
+
+	inline Quaternion quatExp(const Vector& v)
+	{
+		const float halfAngle = v.length();
+
+		if (halfAngle < 1e-7f)
+			return normalizeQuat(Quaternion(1.f, v.X, v.Y, v.Z));
+
+		const float s = std::sin(halfAngle) / halfAngle;
+
+		return Quaternion(std::cos(halfAngle), v.X * s, v.Y * s, v.Z * s);
+	}
+
+	// Rotation of degrees around a unit axis.
+	inline Quaternion makeQuatFromAxisAngle(const Vector& axis, float degrees)
+	{
+		const float half = toRadians(degrees) / 2.f;
+		const float s = std::sin(half);
+
+		return Quaternion(std::cos(half), axis.X * s, axis.Y * s, axis.Z * s);
+	}
+
+	// Inverse of convertEulerAnglesToQuat for unit quaternions: finds alpha,
+	// beta, gamma (degrees) with R = Rx(alpha) * Ry(beta) * Rz(gamma).
+	inline EulerAngles convertQuatToEulerAngles(const Quaternion& q)
+	{
+		const auto& m = q.getRotMatrix().matrixInColumnForm;
+
+		const float sinBeta = clamp(-1.f, 1.f, m[8]);
+		const float beta = std::asin(sinBeta);
+
+		float alpha;
+		float gamma;
+
+		if(std::abs(sinBeta) < 0.9999f)
+		{
+			alpha = std::atan2(-m[9], m[10]);
+			gamma = std::atan2(-m[4], m[0]);
+		}
+		else
+		{
+			// Gimbal lock: only alpha + gamma is defined.
+			alpha = std::atan2(m[6], m[5]);
+			gamma = 0.f;
+		}
+
+		return EulerAngles(toDegrees(alpha), toDegrees(beta), toDegrees(gamma));
+	}
+
 	inline Quaternion slerp(const Quaternion& from, const Quaternion& to, float t)
 	{
 		const auto dotProduct = QuaternionDotProduct(from, to);
-	
-		const float theta = acos(dotProduct);
+
+		// q and -q are the same rotation; take the short arc and measure the
+		// angle on that side, otherwise the weights no longer sum to a unit
+		// quaternion.
+		const float theta = acos(clamp(0.f, 1.f, std::abs(dotProduct)));
 
 		const auto edgeTheta = 0.000001;
 
@@ -340,37 +453,21 @@
 	float B;
 	};
 
-	struct Rotation
-	{
-	Rotation(float pAngle = 0, const Vector& pDirs = Vector{})
-		:
-		angle{ pAngle },
-		dirs{ pDirs }
-	{
-
-	}
-
-	float angle;
-	Vector dirs;
-	};
-
+	// Placement passed to actor constructors; see Pose for what actors keep.
 	struct Transform
 	{
 	Transform(const Vector& pTranslation = {},
-		const Vector& pScale = {},
-		const Rotation& pRotation = {}
+		const Vector& pScale = {}
 	)
 		:
 		translation{ pTranslation },
-		scale{ pScale },
-		rotation{ pRotation }
+		scale{ pScale }
 	{
 
 	}
 
 	Vector translation;
 	Vector scale;
-	Rotation rotation;
 	};
 
 	struct Random
@@ -394,6 +491,11 @@
 		return random;
 	}
 
+	void seed(unsigned int s)
+	{
+		mt.seed(s);
+	}
+
 	private:
 	Random()
 		:
@@ -421,9 +523,30 @@
 	return colors[Random::get().getRandomInt(0,colors.size() - 1)];
 	}
 
-	inline void writeBitmapString(void* font, const std::string& str)
+	// Uniformly distributed rotation (Shoemake's method).
+	inline Quaternion getRandomOrientation()
 	{
-	for (const auto ch : str) glutBitmapCharacter(font, ch);
+		auto& random = Random::get();
+
+		const float u1 = random.getRandomFloat(0.f, 1.f);
+		const float u2 = random.getRandomFloat(0.f, 2.f * M_PI);
+		const float u3 = random.getRandomFloat(0.f, 2.f * M_PI);
+
+		const float a = std::sqrt(1.f - u1);
+		const float b = std::sqrt(u1);
+
+		return Quaternion(a * std::sin(u2), a * std::cos(u2), b * std::sin(u3), b * std::cos(u3));
+	}
+
+	inline Vector getRandomLocation(float extent)
+	{
+		auto& random = Random::get();
+
+		return {
+			random.getRandomFloat(-extent, extent),
+			random.getRandomFloat(-extent, extent),
+			random.getRandomFloat(-extent, extent)
+		};
 	}
 
 	inline bool checkSphereCollision(const Vector& sph1Loc, float r1, const Vector& sph2Loc, float r2)
@@ -0,0 +1,99 @@
+#include "Telemetry.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Tails the telemetry ring of a running lerpWithQuats --telemetry <name> and
+// prints one JSON object per simulation frame. With --once, prints the latest
+// frame and exits.
+
+static void printFrame(const TelemetryFrame& f)
+{
+    std::cout << "{\"frame\": " << f.frame
+              << ", \"timestampNs\": " << f.timestampNs
+              << ", \"frameMs\": " << f.frameMs
+              << ", \"stepMs\": " << f.stepMs
+              << ", \"phasesMs\": {\"input\": " << f.inputMs
+              << ", \"scripts\": " << f.scriptsMs
+              << ", \"tick\": " << f.tickMs
+              << ", \"record\": " << f.recordMs
+              << ", \"snapshot\": " << f.snapshotMs << "}"
+              << ", \"actors\": " << f.actors
+              << ", \"tickedActors\": " << f.tickedActors
+              << ", \"sleepingActors\": " << f.sleepingActors
+              << ", \"activeMotions\": " << f.activeMotions
+              << ", \"resumedScripts\": " << f.resumedScripts
+              << ", \"renderItems\": " << f.renderItems
+              << ", \"allocations\": " << f.allocations
+              << ", \"totalAllocations\": " << f.totalAllocations << "}\n";
+}
+
+int main(int argc, char** argv)
+{
+    std::string name{"/lerpWithQuats"};
+    bool once{};
+    int intervalMs{50};
+
+    for(int i = 1; i < argc; ++i)
+    {
+        if(std::strcmp(argv[i], "--once") == 0)
+            once = true;
+        else if(std::strcmp(argv[i], "--interval-ms") == 0 && i + 1 < argc)
+            intervalMs = std::stoi(argv[++i]);
+        else if(argv[i][0] == '-')
+        {
+            std::cerr << "usage: telemetryTail [name] [--once] [--interval-ms n]" << std::endl;
+            return 1;
+        }
+        else
+            name = argv[i];
+    }
+
+    const TelemetryReader reader{name};
+
+    if(!reader.isOpen())
+        return 1;
+
+    TelemetryFrame frame;
+
+    if(once)
+    {
+        const auto written = reader.getWriteCount();
+
+        if(written == 0 || !reader.read(written - 1, frame))
+        {
+            std::cerr << "No frame published yet" << std::endl;
+            return 1;
+        }
+
+        printFrame(frame);
+        return 0;
+    }
+
+    // Start from what is still in the ring; when the poll falls a whole ring
+    // behind, skip ahead and report how many frames were lost.
+    std::uint64_t next = 0;
+    const std::uint64_t slots = reader.getSlotCount();
+
+    for(;;)
+    {
+        const auto written = reader.getWriteCount();
+
+        if(written > next + slots)
+        {
+            std::cerr << "dropped " << written - slots - next << " frames" << std::endl;
+            next = written - slots;
+        }
+
+        for(; next < written; ++next)
+        {
+            if(reader.read(next, frame))
+                printFrame(frame);
+        }
+
+        std::cout.flush();
+        std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+    }
+}